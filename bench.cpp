@@ -0,0 +1,161 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include "file_panel.h"
+#include "dir_reader.h"
+#include "listing_sort.h"
+#include "colorizer.h"
+
+#define BENCH_TERM_COLS "160"
+#define BENCH_TERM_LINES "48"
+
+using bench_clock = std::chrono::steady_clock;
+
+static double elapsed_ms(bench_clock::time_point _since) {
+    return std::chrono::duration<double, std::milli>(bench_clock::now() - _since).count();
+}
+
+static bool generate_directory(const std::string &_path, size_t _count) {
+    std::error_code ec;
+    std::filesystem::remove_all(_path, ec);
+    if (mkdir(_path.c_str(), 0755) != 0) {
+        return false;
+    }
+    int dirfd = open_directory(_path);
+    if (dirfd == -1) {
+        return false;
+    }
+    static const char *extensions[] = {".txt", ".c", ".tmp", ".dat", ".hpp"};
+    char name[64];
+    for (size_t i = 0; i < _count; i++) {
+        size_t kind = i % 20;
+        if (kind < 14) {
+            snprintf(name, sizeof(name), "file_%zu%s", i, extensions[i % 5]);
+            int fd = openat(dirfd, name, O_CREAT | O_WRONLY | O_CLOEXEC, 0644);
+            if (fd == -1) {
+                close(dirfd);
+                return false;
+            }
+            close(fd);
+        } else if (kind < 16) {
+            snprintf(name, sizeof(name), "dir_%zu", i);
+            mkdirat(dirfd, name, 0755);
+        } else if (kind < 19) {
+            char target[64];
+            snprintf(target, sizeof(target), "file_%zu%s", i - kind, extensions[(i - kind) % 5]);
+            snprintf(name, sizeof(name), "link_%zu", i);
+            symlinkat(target, dirfd, name);
+        } else {
+            snprintf(name, sizeof(name), "dangling_%zu", i);
+            symlinkat("missing_target", dirfd, name);
+        }
+    }
+    close(dirfd);
+    return true;
+}
+
+static bool bench_directory(const std::string &_path, size_t _count, bool _first) {
+    auto start = bench_clock::now();
+    if (!generate_directory(_path, _count)) {
+        fprintf(stderr, "cannot generate %s: %s\n", _path.c_str(), strerror(errno));
+        return false;
+    }
+    double generate_ms = elapsed_ms(start);
+
+    start = bench_clock::now();
+    int dirfd = open_directory(_path);
+    auto arena = std::make_shared<name_arena>();
+    std::vector<raw_entry> entries;
+    read_directory_entries(dirfd, entries, *arena);
+    double list_ms = elapsed_ms(start);
+
+    start = bench_clock::now();
+    listing content;
+    content.adopt_arena(arena);
+    build_directory_listing(dirfd, entries, content);
+    double classify_ms = elapsed_ms(start);
+    close(dirfd);
+
+    printf("%s    {\n", _first ? "" : ",\n");
+    printf("      \"entries\": %zu,\n", _count);
+    printf("      \"generate_ms\": %.3f,\n", generate_ms);
+    printf("      \"list_ms\": %.3f,\n", list_ms);
+    printf("      \"classify_ms\": %.3f,\n", classify_ms);
+    printf("      \"sort_ms\": {");
+    for (int mode = 0; mode < SORT_MODE_COUNT; mode++) {
+        sort_order order{static_cast<SORT_MODE>(mode), false};
+        start = bench_clock::now();
+        content.apply_permutation(sort_permutation(content, order));
+        content.remember_permutation(sort_slot(order));
+        printf("%s\"%s\": %.3f", mode == 0 ? "" : ", ", sort_mode_label(order.mode), elapsed_ms(start));
+    }
+    printf("},\n");
+    start = bench_clock::now();
+    content.restore_permutation(sort_slot(sort_order()));
+    printf("      \"cached_resort_ms\": %.3f,\n", elapsed_ms(start));
+
+    start = bench_clock::now();
+    {
+        file_panel panel(_path, LINES - 1, COLS / 2, 0, 0);
+        double panel_open_ms = elapsed_ms(start);
+        panel.set_active_panel(true);
+        start = bench_clock::now();
+        panel.display_content();
+        flush_frame();
+        double first_frame_ms = elapsed_ms(start);
+        printf("      \"panel_open_ms\": %.3f,\n", panel_open_ms);
+        printf("      \"first_frame_ms\": %.3f\n", first_frame_ms);
+    }
+    printf("    }");
+    fflush(stdout);
+
+    std::error_code ec;
+    std::filesystem::remove_all(_path, ec);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    std::vector<size_t> sizes;
+    for (int i = 1; i < argc; i++) {
+        sizes.push_back(strtoul(argv[i], nullptr, 10));
+    }
+    if (sizes.empty()) {
+        sizes = {1000, 100000, 1000000};
+    }
+    const char *base = getenv("BENCH_DIR");
+    std::string base_dir = base != nullptr ? base : "/tmp";
+
+    entry_colorizer.load_environment();
+    setenv("COLUMNS", BENCH_TERM_COLS, 1);
+    setenv("LINES", BENCH_TERM_LINES, 1);
+    FILE *null_out = fopen("/dev/null", "w");
+    FILE *null_in = fopen("/dev/null", "r");
+    const char *term = getenv("TERM");
+    SCREEN *screen = newterm(term != nullptr ? term : "xterm", null_out, null_in);
+    if (screen == nullptr) {
+        screen = newterm("xterm", null_out, null_in);
+    }
+    if (screen == nullptr) {
+        fprintf(stderr, "cannot initialise a terminal for rendering\n");
+        return 1;
+    }
+    set_term(screen);
+    start_color();
+    init_colors();
+
+    printf("{\n  \"benchmarks\": [\n");
+    bool ok = true;
+    for (size_t i = 0; i < sizes.size() && ok; i++) {
+        std::string path = base_dir + "/listing_bench_" + std::to_string(sizes[i]);
+        ok = bench_directory(path, sizes[i], i == 0);
+    }
+    printf("\n  ]\n}\n");
+
+    endwin();
+    delscreen(screen);
+    fclose(null_out);
+    fclose(null_in);
+    return ok ? 0 : 1;
+}
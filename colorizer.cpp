@@ -0,0 +1,193 @@
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include "colorizer.h"
+
+colorizer entry_colorizer;
+
+static uint32_t suffix_hash(std::string_view _suffix) {
+    uint32_t hash = 2166136261u;
+    for (unsigned char ch: _suffix) {
+        hash = (hash ^ ch) * 16777619u;
+    }
+    return hash;
+}
+
+static bool sgr_to_color(std::string_view _sgr, COLOR_INDEX &_color) {
+    static const COLOR_INDEX palette[8] = {WHITE_COLOR, RED_COLOR, GREEN_COLOR, YELLOW_COLOR,
+                                           BLUE_COLOR, MAGENTA_COLOR, CYAN_COLOR, WHITE_COLOR};
+    std::vector<int> codes;
+    while (!_sgr.empty()) {
+        size_t end = _sgr.find(';');
+        std::string_view token = _sgr.substr(0, end);
+        int code = 0;
+        for (char ch: token) {
+            if (ch < '0' || ch > '9') {
+                return false;
+            }
+            code = code * 10 + (ch - '0');
+        }
+        codes.push_back(code);
+        _sgr = end == std::string_view::npos ? std::string_view() : _sgr.substr(end + 1);
+    }
+    bool found = false;
+    for (size_t i = 0; i < codes.size(); i++) {
+        if (codes[i] == 38 && i + 2 < codes.size() && codes[i + 1] == 5) {
+            if (codes[i + 2] < 16) {
+                _color = palette[codes[i + 2] % 8];
+                found = true;
+            }
+            i += 2;
+        } else if ((codes[i] >= 30 && codes[i] <= 37) || (codes[i] >= 90 && codes[i] <= 97)) {
+            _color = palette[codes[i] % 10];
+            found = true;
+        } else if (codes[i] == 48 && i + 2 < codes.size() && codes[i + 1] == 5) {
+            i += 2;
+        }
+    }
+    return found;
+}
+
+colorizer::colorizer() {
+    this->mask = 0;
+    this->dir_color = MAGENTA_COLOR;
+    this->link_color = WHITE_COLOR;
+    this->orphan_color = RED_COLOR;
+    this->file_color = WHITE_COLOR;
+    this->exec_color = WHITE_COLOR;
+    this->has_exec_color = false;
+    parse(DEFAULT_LS_COLORS);
+}
+
+void colorizer::add_rule(std::string_view _key, COLOR_INDEX _color) {
+    if (_key == "di") {
+        dir_color = _color;
+    } else if (_key == "ln") {
+        link_color = _color;
+    } else if (_key == "or") {
+        orphan_color = _color;
+    } else if (_key == "fi") {
+        file_color = _color;
+    } else if (_key == "ex") {
+        exec_color = _color;
+        has_exec_color = true;
+    } else if (_key.size() > 1 && _key[0] == '*') {
+        std::string_view suffix = _key.substr(1);
+        auto it = std::find_if(rules.begin(), rules.end(),
+                               [&](const std::pair<std::string, COLOR_INDEX> &rule) { return rule.first == suffix; });
+        if (it != rules.end()) {
+            it->second = _color;
+        } else {
+            rules.emplace_back(suffix, _color);
+        }
+    }
+}
+
+void colorizer::parse(std::string_view _spec) {
+    while (!_spec.empty()) {
+        size_t end = _spec.find_first_of(":\n");
+        std::string_view entry = _spec.substr(0, end);
+        _spec = end == std::string_view::npos ? std::string_view() : _spec.substr(end + 1);
+        size_t eq = entry.find('=');
+        COLOR_INDEX color;
+        if (eq == std::string_view::npos || !sgr_to_color(entry.substr(eq + 1), color)) {
+            continue;
+        }
+        std::string_view key = entry.substr(0, eq);
+        while (!key.empty() && (key.front() == ' ' || key.front() == '\t')) {
+            key.remove_prefix(1);
+        }
+        add_rule(key, color);
+    }
+    rebuild();
+}
+
+bool colorizer::load_file(const std::string &_path) {
+    std::ifstream file(_path);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::stringstream spec;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line[0] != '#') {
+            spec << line << ':';
+        }
+    }
+    parse(spec.str());
+    return true;
+}
+
+void colorizer::load_environment() {
+    const char *ls_colors = getenv("LS_COLORS");
+    if (ls_colors != nullptr) {
+        parse(ls_colors);
+    }
+    const char *home = getenv("HOME");
+    if (home != nullptr) {
+        load_file(std::string(home) + COLORS_CONFIG_FILE);
+    }
+}
+
+void colorizer::rebuild() {
+    size_t capacity = COLORIZER_MIN_SLOTS;
+    while (capacity < rules.size() * 2) {
+        capacity *= 2;
+    }
+    mask = capacity - 1;
+    slots.assign(capacity, slot{0, 0, 0, WHITE_COLOR});
+    suffix_lengths.clear();
+    pool.clear();
+    for (auto &&rule: rules) {
+        uint32_t hash = suffix_hash(rule.first);
+        size_t ind = hash & mask;
+        while (slots[ind].length != 0) {
+            ind = (ind + 1) & mask;
+        }
+        slots[ind] = {hash, static_cast<uint32_t>(pool.size()), static_cast<uint32_t>(rule.first.size()), rule.second};
+        pool += rule.first;
+        if (std::find(suffix_lengths.begin(), suffix_lengths.end(), rule.first.size()) == suffix_lengths.end()) {
+            suffix_lengths.push_back(static_cast<uint32_t>(rule.first.size()));
+        }
+    }
+    std::sort(suffix_lengths.begin(), suffix_lengths.end(), std::greater<>());
+}
+
+COLOR_INDEX colorizer::suffix_color(std::string_view _name, COLOR_INDEX _fallback) const {
+    for (uint32_t len: suffix_lengths) {
+        if (len > _name.size()) {
+            continue;
+        }
+        std::string_view suffix = _name.substr(_name.size() - len);
+        uint32_t hash = suffix_hash(suffix);
+        for (size_t ind = hash & mask; slots[ind].length != 0; ind = (ind + 1) & mask) {
+            const slot &s = slots[ind];
+            if (s.hash == hash && s.length == len && memcmp(pool.data() + s.offset, suffix.data(), len) == 0) {
+                return s.color;
+            }
+        }
+    }
+    return _fallback;
+}
+
+COLOR_INDEX colorizer::color_for(CONTENT_TYPE _content_type, mode_t _mode, std::string_view _name) const {
+    switch (_content_type) {
+        case CONTENT_TYPE::IS_DIR :
+        case CONTENT_TYPE::IS_LNK_TO_DIR :
+            return dir_color;
+        case CONTENT_TYPE::IS_HANGING_LINK :
+            return orphan_color;
+        case CONTENT_TYPE::IS_LNK :
+            return link_color;
+        default :
+            break;
+    }
+    if ((_mode & S_IFMT) != S_IFREG) {
+        return file_color;
+    }
+    if (has_exec_color && (_mode & (S_IXUSR | S_IXGRP | S_IXOTH))) {
+        return exec_color;
+    }
+    return suffix_color(_name, file_color);
+}
@@ -0,0 +1,46 @@
+#ifndef COURSE_PROJECT_COLORIZER_H
+#define COURSE_PROJECT_COLORIZER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sys/stat.h>
+#include "file_panel.h"
+
+#define DEFAULT_LS_COLORS "di=35:ln=37:or=31:fi=37:*.tmp=34:*.txt=33:*.c=32:*.cpp=32:*.h=32:*.hpp=32"
+#define COLORS_CONFIG_FILE "/.config/course_project/colors"
+#define COLORIZER_MIN_SLOTS 16
+
+class colorizer {
+private:
+    struct slot {
+        uint32_t hash;
+        uint32_t offset;
+        uint32_t length;
+        COLOR_INDEX color;
+    };
+    std::vector<std::pair<std::string, COLOR_INDEX>> rules;
+    std::vector<slot> slots;
+    std::vector<uint32_t> suffix_lengths;
+    std::string pool;
+    size_t mask;
+    COLOR_INDEX dir_color;
+    COLOR_INDEX link_color;
+    COLOR_INDEX orphan_color;
+    COLOR_INDEX file_color;
+    COLOR_INDEX exec_color;
+    bool has_exec_color;
+    void add_rule(std::string_view _key, COLOR_INDEX _color);
+    void rebuild();
+    [[nodiscard]] COLOR_INDEX suffix_color(std::string_view _name, COLOR_INDEX _fallback) const;
+public:
+    colorizer();
+    void parse(std::string_view _spec);
+    bool load_file(const std::string& _path);
+    void load_environment();
+    [[nodiscard]] COLOR_INDEX color_for(CONTENT_TYPE _content_type, mode_t _mode, std::string_view _name) const;
+};
+
+extern colorizer entry_colorizer;
+
+#endif //COURSE_PROJECT_COLORIZER_H
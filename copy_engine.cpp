@@ -0,0 +1,429 @@
+#include <cerrno>
+#include <cstdio>
+#include <memory>
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "copy_engine.h"
+#include "copy_verify.h"
+
+copy_method_stats copy_stats;
+
+namespace {
+
+struct scoped_fd {
+    int fd;
+    explicit scoped_fd(int _fd) : fd(_fd) {}
+    ~scoped_fd() {
+        if (fd != -1) {
+            close(fd);
+        }
+    }
+    scoped_fd(const scoped_fd&) = delete;
+    scoped_fd& operator=(const scoped_fd&) = delete;
+};
+
+[[noreturn]] void throw_copy_error(const std::filesystem::path &_from, const std::filesystem::path &_to, int _error) {
+    throw std::filesystem::filesystem_error("cannot copy file", _from, _to,
+                                            std::error_code(_error, std::generic_category()));
+}
+
+// The syscall is not supported for this pair of files, as opposed to a real
+// I/O failure; only these let the engine fall through to the next method.
+bool is_unsupported(int _error) {
+    return _error == EXDEV || _error == ENOSYS || _error == EOPNOTSUPP || _error == EINVAL
+           || _error == ENOTTY || _error == EBADF || _error == ETXTBSY;
+}
+
+void advance(std::atomic<uint64_t> *_progress, ssize_t _bytes) {
+    if (_progress != nullptr) {
+        _progress->fetch_add(static_cast<uint64_t>(_bytes), std::memory_order_relaxed);
+    }
+}
+
+bool clone_file(int _in, int _out) {
+    return ioctl(_out, FICLONE, _in) == 0;
+}
+
+// Returns -1 with errno set on failure, otherwise the bytes moved. A failure
+// before the first byte with an "unsupported" errno means try the next method.
+ssize_t copy_range_file(int _in, int _out, std::atomic<uint64_t> *_progress) {
+    ssize_t total = 0;
+    while (true) {
+        ssize_t n = copy_file_range(_in, nullptr, _out, nullptr, COPY_RANGE_CHUNK, 0);
+        if (n == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (n == 0) {
+            return total;
+        }
+        total += n;
+        advance(_progress, n);
+    }
+}
+
+ssize_t sendfile_file(int _in, int _out, std::atomic<uint64_t> *_progress) {
+    ssize_t total = 0;
+    while (true) {
+        ssize_t n = sendfile(_out, _in, nullptr, COPY_RANGE_CHUNK);
+        if (n == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (n == 0) {
+            return total;
+        }
+        total += n;
+        advance(_progress, n);
+    }
+}
+
+void update_checksum(uint32_t *_checksum, const char *_data, ssize_t _length) {
+    if (_checksum != nullptr) {
+        *_checksum = crc32c(*_checksum, _data, static_cast<size_t>(_length));
+    }
+}
+
+// Holes read back as zeros, so that is what they add to the checksum.
+void checksum_zeros(uint32_t *_checksum, off_t _length) {
+    static const char zeros[1 << 16] = {};
+    while (_checksum != nullptr && _length > 0) {
+        off_t n = _length < static_cast<off_t>(sizeof(zeros)) ? _length : static_cast<off_t>(sizeof(zeros));
+        *_checksum = crc32c(*_checksum, zeros, static_cast<size_t>(n));
+        _length -= n;
+    }
+}
+
+// Holes show up as fewer allocated blocks than the size would need.
+bool is_sparse(const struct stat &_stat) {
+    return _stat.st_blocks * 512 < _stat.st_size;
+}
+
+// Reserves the blocks of a range without changing the file size, so the copy
+// lands in as few extents as the filesystem manages; filesystems without
+// fallocate just skip it.
+void preallocate(int _out, off_t _offset, off_t _length) {
+    if (_length > 0) {
+        (void) fallocate(_out, FALLOC_FL_KEEP_SIZE, _offset, _length);
+    }
+}
+
+// Copies [_offset, _offset + _length) to the same offsets of _out, through
+// copy_file_range until it turns out unsupported and pread/pwrite after
+// that. Returns the bytes copied, short only if the source shrank, or -1.
+ssize_t copy_extent(int _in, int _out, off_t _offset, off_t _length, bool &_use_range,
+                    std::unique_ptr<char[]> &_buffer, std::atomic<uint64_t> *_progress, uint32_t *_checksum) {
+    off_t in_offset = _offset;
+    off_t out_offset = _offset;
+    off_t end = _offset + _length;
+    while (in_offset < end) {
+        auto chunk = static_cast<size_t>(end - in_offset < COPY_RANGE_CHUNK ? end - in_offset : COPY_RANGE_CHUNK);
+        ssize_t n;
+        if (_use_range) {
+            n = copy_file_range(_in, &in_offset, _out, &out_offset, chunk, 0);
+            if (n == -1 && is_unsupported(errno) && in_offset == _offset) {
+                _use_range = false;
+                continue;
+            }
+        } else {
+            if (!_buffer) {
+                _buffer.reset(new char[COPY_BUFFER_SIZE]);
+            }
+            n = pread(_in, _buffer.get(), chunk < COPY_BUFFER_SIZE ? chunk : COPY_BUFFER_SIZE, in_offset);
+            if (n > 0) {
+                update_checksum(_checksum, _buffer.get(), n);
+            }
+            for (ssize_t written = 0; n > 0 && written < n;) {
+                ssize_t w = pwrite(_out, _buffer.get() + written, n - written, out_offset + written);
+                if (w == -1) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    return -1;
+                }
+                written += w;
+            }
+            if (n > 0) {
+                in_offset += n;
+                out_offset += n;
+            }
+        }
+        if (n == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (n == 0) {
+            break;
+        }
+        advance(_progress, n);
+    }
+    return in_offset - _offset;
+}
+
+// Walks the data extents with SEEK_DATA/SEEK_HOLE, preallocates and copies
+// each one and leaves the holes unwritten; the final ftruncate restores the
+// size past a trailing hole. Returns the data bytes copied, or -1 with errno
+// set; an "unsupported" errno means SEEK_DATA itself is not available and
+// nothing was written yet. A checksum needs the data in user space, so it
+// keeps the extents on pread/pwrite.
+ssize_t sparse_file(int _in, int _out, off_t _size, std::atomic<uint64_t> *_progress, uint32_t *_checksum) {
+    std::unique_ptr<char[]> buffer;
+    bool use_range = _checksum == nullptr;
+    ssize_t total = 0;
+    off_t offset = 0;
+    while (offset < _size) {
+        off_t data = lseek(_in, offset, SEEK_DATA);
+        if (data == -1) {
+            if (errno == ENXIO) {
+                break;
+            }
+            return -1;
+        }
+        off_t hole = lseek(_in, data, SEEK_HOLE);
+        if (hole == -1) {
+            return -1;
+        }
+        // Progress follows the logical size, so skipped holes count as done.
+        advance(_progress, data - offset);
+        checksum_zeros(_checksum, data - offset);
+        preallocate(_out, data, hole - data);
+        ssize_t n = copy_extent(_in, _out, data, hole - data, use_range, buffer, _progress, _checksum);
+        if (n == -1) {
+            return -1;
+        }
+        total += n;
+        offset = data + n;
+        if (n < hole - data) {
+            break;
+        }
+    }
+    if (offset < _size) {
+        advance(_progress, _size - offset);
+        checksum_zeros(_checksum, _size - offset);
+    }
+    if (ftruncate(_out, _size) == -1) {
+        return -1;
+    }
+    return total;
+}
+
+ssize_t buffered_file(int _in, int _out, std::atomic<uint64_t> *_progress, uint32_t *_checksum) {
+    std::unique_ptr<char[]> buffer(new char[COPY_BUFFER_SIZE]);
+    ssize_t total = 0;
+    while (true) {
+        ssize_t n = read(_in, buffer.get(), COPY_BUFFER_SIZE);
+        if (n == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (n == 0) {
+            return total;
+        }
+        update_checksum(_checksum, buffer.get(), n);
+        for (ssize_t written = 0; written < n;) {
+            ssize_t w = write(_out, buffer.get() + written, n - written);
+            if (w == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return -1;
+            }
+            written += w;
+        }
+        total += n;
+        advance(_progress, n);
+    }
+}
+
+}
+
+copy_method_stats::copy_method_stats() : files(), bytes(), logical(), trees(0), tree_files(0), tree_bytes(0), tree_ns(0) {}
+
+void copy_method_stats::record(COPY_METHOD _method, uint64_t _bytes, uint64_t _logical) {
+    if (_method == COPY_METHOD::NONE) {
+        return;
+    }
+    files[static_cast<size_t>(_method)].fetch_add(1, std::memory_order_relaxed);
+    bytes[static_cast<size_t>(_method)].fetch_add(_bytes, std::memory_order_relaxed);
+    logical[static_cast<size_t>(_method)].fetch_add(_logical, std::memory_order_relaxed);
+}
+
+void copy_method_stats::record_tree(uint64_t _files, uint64_t _bytes, uint64_t _ns) {
+    trees.fetch_add(1, std::memory_order_relaxed);
+    tree_files.fetch_add(_files, std::memory_order_relaxed);
+    tree_bytes.fetch_add(_bytes, std::memory_order_relaxed);
+    tree_ns.fetch_add(_ns, std::memory_order_relaxed);
+}
+
+uint64_t copy_method_stats::get_files(COPY_METHOD _method) const {
+    return _method == COPY_METHOD::NONE ? 0 : files[static_cast<size_t>(_method)].load();
+}
+
+uint64_t copy_method_stats::get_bytes(COPY_METHOD _method) const {
+    return _method == COPY_METHOD::NONE ? 0 : bytes[static_cast<size_t>(_method)].load();
+}
+
+uint64_t copy_method_stats::get_logical(COPY_METHOD _method) const {
+    return _method == COPY_METHOD::NONE ? 0 : logical[static_cast<size_t>(_method)].load();
+}
+
+std::string copy_method_stats::to_json() const {
+    std::string result = "{";
+    for (size_t method = 0; method < COPY_METHOD_COUNT; method++) {
+        auto kind = static_cast<COPY_METHOD>(method);
+        result += (method == 0 ? "\"" : ", \"") + std::string(copy_method_label(kind)) + "\": {\"files\": "
+                  + std::to_string(get_files(kind)) + ", \"bytes\": " + std::to_string(get_bytes(kind))
+                  + ", \"logical\": " + std::to_string(get_logical(kind)) + "}";
+    }
+    uint64_t ns = tree_ns.load();
+    char throughput[32];
+    snprintf(throughput, sizeof(throughput), "%.3f",
+             ns == 0 ? 0.0 : static_cast<double>(tree_bytes.load()) / 1e6 / (static_cast<double>(ns) / 1e9));
+    result += ", \"trees\": {\"count\": " + std::to_string(trees.load()) + ", \"files\": "
+              + std::to_string(tree_files.load()) + ", \"bytes\": " + std::to_string(tree_bytes.load())
+              + ", \"mb_per_s\": " + throughput + "}";
+    return result + "}";
+}
+
+const char *copy_method_label(COPY_METHOD _method) {
+    switch (_method) {
+        case COPY_METHOD::CLONE : return "clone";
+        case COPY_METHOD::COPY_RANGE : return "copy_range";
+        case COPY_METHOD::SENDFILE : return "sendfile";
+        case COPY_METHOD::BUFFERED : return "buffered";
+        case COPY_METHOD::URING : return "uring";
+        case COPY_METHOD::SPARSE : return "sparse";
+        default : return "none";
+    }
+}
+
+COPY_METHOD copy_file_native(const std::filesystem::path &_from, const std::filesystem::path &_to,
+                             std::filesystem::copy_options _options, uint64_t *_bytes,
+                             std::atomic<uint64_t> *_progress, uint32_t *_checksum) {
+    // Type check before open: opening a fifo for reading would block.
+    struct stat from_stat {};
+    if (stat(_from.c_str(), &from_stat) == -1) {
+        throw_copy_error(_from, _to, errno);
+    }
+    if (!S_ISREG(from_stat.st_mode)) {
+        // Devices, fifos and sockets keep the library's behaviour.
+        return std::filesystem::copy_file(_from, _to, _options) ? COPY_METHOD::BUFFERED : COPY_METHOD::NONE;
+    }
+    scoped_fd in(open(_from.c_str(), O_RDONLY | O_CLOEXEC | O_NONBLOCK));
+    if (in.fd == -1) {
+        throw_copy_error(_from, _to, errno);
+    }
+    if (fstat(in.fd, &from_stat) == -1) {
+        throw_copy_error(_from, _to, errno);
+    }
+    if (!S_ISREG(from_stat.st_mode)) {
+        throw_copy_error(_from, _to, EINVAL);
+    }
+    // O_NONBLOCK only guarded the open against a fifo swapped in after the
+    // stat; on a regular file it can still surface EAGAIN (FUSE, mandatory
+    // locks), so the copy itself runs blocking.
+    int in_flags = fcntl(in.fd, F_GETFL);
+    if (in_flags == -1 || fcntl(in.fd, F_SETFL, in_flags & ~O_NONBLOCK) == -1) {
+        throw_copy_error(_from, _to, errno);
+    }
+
+    struct stat to_stat {};
+    if (stat(_to.c_str(), &to_stat) == 0) {
+        if (to_stat.st_dev == from_stat.st_dev && to_stat.st_ino == from_stat.st_ino) {
+            throw_copy_error(_from, _to, EEXIST);
+        }
+        using std::filesystem::copy_options;
+        if ((_options & copy_options::skip_existing) != copy_options::none) {
+            return COPY_METHOD::NONE;
+        }
+        if ((_options & copy_options::update_existing) != copy_options::none) {
+            if (from_stat.st_mtim.tv_sec < to_stat.st_mtim.tv_sec
+                || (from_stat.st_mtim.tv_sec == to_stat.st_mtim.tv_sec
+                    && from_stat.st_mtim.tv_nsec <= to_stat.st_mtim.tv_nsec)) {
+                return COPY_METHOD::NONE;
+            }
+        } else if ((_options & copy_options::overwrite_existing) == copy_options::none) {
+            throw_copy_error(_from, _to, EEXIST);
+        }
+    } else if (errno != ENOENT) {
+        throw_copy_error(_from, _to, errno);
+    }
+
+    scoped_fd out(open(_to.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, from_stat.st_mode & 07777));
+    if (out.fd == -1) {
+        throw_copy_error(_from, _to, errno);
+    }
+    if (fchmod(out.fd, from_stat.st_mode & 07777) == -1) {
+        throw_copy_error(_from, _to, errno);
+    }
+
+    COPY_METHOD method = COPY_METHOD::BUFFERED;
+    ssize_t copied = -1;
+    if (_checksum != nullptr) {
+        *_checksum = 0;
+    }
+    // Zero-sized regular files may still be synthetic (procfs, sysfs), which
+    // only a read loop copies correctly; real empty files cost nothing there.
+    if (from_stat.st_size > 0) {
+        // Clone, copy_file_range and sendfile never show the data to user
+        // space, so a checksum keeps the copy on the read loops.
+        if (_checksum == nullptr && clone_file(in.fd, out.fd)) {
+            method = COPY_METHOD::CLONE;
+            copied = from_stat.st_size;
+            advance(_progress, copied);
+        } else {
+            // A clone shares extents and keeps holes by itself; anything
+            // else would fill them with zeros, so sparse files go by extent.
+            if (is_sparse(from_stat)) {
+                copied = sparse_file(in.fd, out.fd, from_stat.st_size, _progress, _checksum);
+                if (copied != -1) {
+                    method = COPY_METHOD::SPARSE;
+                } else if (!is_unsupported(errno) || lseek(in.fd, 0, SEEK_SET) == -1) {
+                    throw_copy_error(_from, _to, errno);
+                }
+            }
+            if (copied == -1) {
+                preallocate(out.fd, 0, from_stat.st_size);
+            }
+            if (copied == -1 && _checksum == nullptr) {
+                if ((copied = copy_range_file(in.fd, out.fd, _progress)) != -1) {
+                    method = COPY_METHOD::COPY_RANGE;
+                } else if (is_unsupported(errno) && (copied = sendfile_file(in.fd, out.fd, _progress)) != -1) {
+                    method = COPY_METHOD::SENDFILE;
+                } else if (!is_unsupported(errno)) {
+                    throw_copy_error(_from, _to, errno);
+                }
+            }
+        }
+    }
+    if (copied == -1) {
+        copied = buffered_file(in.fd, out.fd, _progress, _checksum);
+        if (copied == -1) {
+            throw_copy_error(_from, _to, errno);
+        }
+    }
+    if (close(out.fd) == -1) {
+        out.fd = -1;
+        throw_copy_error(_from, _to, errno);
+    }
+    out.fd = -1;
+    copy_stats.record(method, static_cast<uint64_t>(copied),
+                      method == COPY_METHOD::SPARSE ? static_cast<uint64_t>(from_stat.st_size)
+                                                    : static_cast<uint64_t>(copied));
+    if (_bytes != nullptr) {
+        *_bytes = static_cast<uint64_t>(copied);
+    }
+    return method;
+}
@@ -0,0 +1,63 @@
+#ifndef COURSE_PROJECT_COPY_ENGINE_H
+#define COURSE_PROJECT_COPY_ENGINE_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+#define COPY_BUFFER_SIZE (1 << 20)
+#define COPY_RANGE_CHUNK (1 << 30)
+
+enum class COPY_METHOD : unsigned char {
+    CLONE = 0,
+    COPY_RANGE = 1,
+    SENDFILE = 2,
+    BUFFERED = 3,
+    URING = 4,
+    SPARSE = 5,
+    NONE = 6,
+};
+
+#define COPY_METHOD_COUNT 6
+
+class copy_method_stats {
+private:
+    std::array<std::atomic<uint64_t>, COPY_METHOD_COUNT> files;
+    std::array<std::atomic<uint64_t>, COPY_METHOD_COUNT> bytes;
+    std::array<std::atomic<uint64_t>, COPY_METHOD_COUNT> logical;
+    std::atomic<uint64_t> trees;
+    std::atomic<uint64_t> tree_files;
+    std::atomic<uint64_t> tree_bytes;
+    std::atomic<uint64_t> tree_ns;
+public:
+    copy_method_stats();
+    void record(COPY_METHOD _method, uint64_t _bytes, uint64_t _logical);
+    void record_tree(uint64_t _files, uint64_t _bytes, uint64_t _ns);
+    [[nodiscard]] uint64_t get_files(COPY_METHOD _method) const;
+    [[nodiscard]] uint64_t get_bytes(COPY_METHOD _method) const;
+    [[nodiscard]] uint64_t get_logical(COPY_METHOD _method) const;
+    [[nodiscard]] std::string to_json() const;
+};
+
+// Same contract as std::filesystem::copy_file (throws filesystem_error,
+// honours skip/overwrite/update_existing), but regular files go through
+// FICLONE, copy_file_range, sendfile and a buffered loop, in that order.
+// Sparse files that cannot be cloned copy only their data extents and keep
+// their holes; the target is preallocated either way.
+// Returns the method that moved the data, or NONE when nothing was copied;
+// _bytes, when given, receives the number of bytes written, and _progress
+// is advanced chunk by chunk by the logical size covered. _checksum, when
+// given, receives the crc32c of a regular file's contents as they were
+// copied; that takes the read/write loops instead of clone and the
+// in-kernel copies.
+COPY_METHOD copy_file_native(const std::filesystem::path& _from, const std::filesystem::path& _to,
+                             std::filesystem::copy_options _options = std::filesystem::copy_options::none,
+                             uint64_t* _bytes = nullptr, std::atomic<uint64_t>* _progress = nullptr,
+                             uint32_t* _checksum = nullptr);
+const char* copy_method_label(COPY_METHOD _method);
+
+extern copy_method_stats copy_stats;
+
+#endif //COURSE_PROJECT_COPY_ENGINE_H
@@ -0,0 +1,167 @@
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <system_error>
+#include <fcntl.h>
+#include <unistd.h>
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
+#include "copy_verify.h"
+
+namespace {
+
+using crc_function = uint32_t (*)(uint32_t, const unsigned char*, size_t);
+
+struct crc_table {
+    uint32_t entries[256];
+    crc_table() : entries() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc & 1) ? (crc >> 1) ^ 0x82F63B78u : crc >> 1;
+            }
+            entries[i] = crc;
+        }
+    }
+};
+
+uint32_t crc32c_table(uint32_t _crc, const unsigned char *_data, size_t _length) {
+    static const crc_table table;
+    while (_length-- > 0) {
+        _crc = table.entries[(_crc ^ *_data++) & 0xFF] ^ (_crc >> 8);
+    }
+    return _crc;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.2")))
+uint32_t crc32c_sse42(uint32_t _crc, const unsigned char *_data, size_t _length) {
+    uint64_t crc = _crc;
+    while (_length >= sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, _data, sizeof(word));
+        crc = _mm_crc32_u64(crc, word);
+        _data += sizeof(word);
+        _length -= sizeof(word);
+    }
+    auto result = static_cast<uint32_t>(crc);
+    while (_length-- > 0) {
+        result = _mm_crc32_u8(result, *_data++);
+    }
+    return result;
+}
+#endif
+
+crc_function pick_crc32c() {
+#if defined(__x86_64__)
+    if (__builtin_cpu_supports("sse4.2")) {
+        return crc32c_sse42;
+    }
+#endif
+    return crc32c_table;
+}
+
+const crc_function crc32c_impl = pick_crc32c();
+
+}
+
+uint32_t crc32c(uint32_t _crc, const void *_data, size_t _length) {
+    return ~crc32c_impl(~_crc, static_cast<const unsigned char*>(_data), _length);
+}
+
+copy_verifier::copy_verifier(done_function _on_done, mismatch_function _on_mismatch) : stopping(false) {
+    this->on_done = std::move(_on_done);
+    this->on_mismatch = std::move(_on_mismatch);
+    for (size_t i = 0; i < VERIFY_THREADS; i++) {
+        workers.emplace_back(&copy_verifier::run, this);
+    }
+}
+
+copy_verifier::~copy_verifier() {
+    finish();
+}
+
+void copy_verifier::add(const std::filesystem::path &_to, uint32_t _checksum) {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        space.wait(lock, [this]() { return queue.size() < VERIFY_QUEUE_LIMIT; });
+        queue.push_back({_to, _checksum});
+    }
+    wake.notify_one();
+}
+
+void copy_verifier::finish() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto &&worker: workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void copy_verifier::run() {
+    while (true) {
+        pending_check next;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                return;
+            }
+            next = std::move(queue.front());
+            queue.pop_front();
+        }
+        space.notify_one();
+        check(next);
+    }
+}
+
+void copy_verifier::check(const pending_check &_check) {
+    int fd = open(_check.to.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        // Not strerror: its buffer is shared, and checks run on several threads.
+        on_mismatch(_check.to, std::generic_category().message(errno));
+        return;
+    }
+    // DONTNEED only drops clean pages, so the copy is written back first;
+    // unlike fdatasync this does not wait for a journal commit per file.
+    (void) sync_file_range(fd, 0, 0, SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE
+                                     | SYNC_FILE_RANGE_WAIT_AFTER);
+    (void) posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    (void) posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    std::unique_ptr<char[]> buffer(new char[VERIFY_BUFFER_SIZE]);
+    uint32_t checksum = 0;
+    int error = 0;
+    while (true) {
+        ssize_t n = read(fd, buffer.get(), VERIFY_BUFFER_SIZE);
+        if (n == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            error = errno;
+            break;
+        }
+        if (n == 0) {
+            break;
+        }
+        checksum = crc32c(checksum, buffer.get(), static_cast<size_t>(n));
+    }
+    // The check itself should not leave the file cached either.
+    (void) posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+    if (error != 0) {
+        on_mismatch(_check.to, std::generic_category().message(error));
+    } else if (checksum != _check.checksum) {
+        char message[64];
+        snprintf(message, sizeof(message), "crc32c %08x, expected %08x", checksum, _check.checksum);
+        on_mismatch(_check.to, message);
+    } else {
+        on_done();
+    }
+}
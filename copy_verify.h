@@ -0,0 +1,59 @@
+#ifndef COURSE_PROJECT_COPY_VERIFY_H
+#define COURSE_PROJECT_COPY_VERIFY_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define VERIFY_BUFFER_SIZE (1 << 20)
+#define VERIFY_QUEUE_LIMIT 64
+#define VERIFY_THREADS 4
+
+// CRC-32C (Castagnoli) of _data, continuing from _crc; start with 0. Uses the
+// SSE4.2 crc32 instruction when the CPU has it and a table otherwise, so
+// checksums match across machines.
+uint32_t crc32c(uint32_t _crc, const void* _data, size_t _length);
+
+// Re-reads copied files on threads of its own and compares them against the
+// checksum taken while they were written, so a copy moves on to the next file
+// while the previous ones are checked. Before reading, the target's dirty
+// pages are written back and dropped from the page cache, so the check sees
+// what reached the disk rather than the copy still sitting in memory; with
+// VERIFY_THREADS files in flight those writeback waits overlap. add() blocks
+// once VERIFY_QUEUE_LIMIT files are waiting; finish() waits for the rest.
+class copy_verifier {
+public:
+    using done_function = std::function<void()>;
+    using mismatch_function = std::function<void(const std::filesystem::path&, const std::string&)>;
+private:
+    struct pending_check {
+        std::filesystem::path to;
+        uint32_t checksum;
+    };
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable space;
+    std::deque<pending_check> queue;
+    bool stopping;
+    done_function on_done;
+    mismatch_function on_mismatch;
+    std::vector<std::thread> workers;
+    void run();
+    void check(const pending_check& _check);
+public:
+    copy_verifier(done_function _on_done, mismatch_function _on_mismatch);
+    ~copy_verifier();
+    copy_verifier(const copy_verifier&) = delete;
+    copy_verifier& operator=(const copy_verifier&) = delete;
+    void add(const std::filesystem::path& _to, uint32_t _checksum);
+    void finish();
+};
+
+#endif //COURSE_PROJECT_COPY_VERIFY_H
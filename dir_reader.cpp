@@ -0,0 +1,300 @@
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include "dir_reader.h"
+#include "colorizer.h"
+
+struct linux_dirent64 {
+    ino64_t d_ino;
+    off64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+int open_directory(const std::string &_path) {
+    return open(_path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+}
+
+bool read_directory_entries(int _dirfd, std::vector<raw_entry> &_entries, name_arena &_arena) {
+    std::unique_ptr<char[]> buffer(new char[GETDENTS_BUFFER_SIZE]);
+    while (true) {
+        long nread = syscall(SYS_getdents64, _dirfd, buffer.get(), GETDENTS_BUFFER_SIZE);
+        if (nread == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        if (nread == 0) {
+            break;
+        }
+        for (long offset = 0; offset < nread;) {
+            auto *d = reinterpret_cast<linux_dirent64 *>(buffer.get() + offset);
+            offset += d->d_reclen;
+            if (d->d_name[0] == '.' && d->d_name[1] == '\0') {
+                continue;
+            }
+            _entries.push_back({_arena.store(d->d_name), d->d_type});
+        }
+    }
+    return true;
+}
+
+bool fetch_entry_metadata(int _dirfd, const char *_name, entry_metadata &_meta) {
+    static std::atomic<bool> statx_supported(true);
+    if (statx_supported.load(std::memory_order_relaxed)) {
+        struct statx stx{};
+        if (statx(_dirfd, _name, AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT | AT_STATX_DONT_SYNC,
+                  STATX_PANEL_MASK, &stx) == 0) {
+            _meta.valid = true;
+            _meta.mode = stx.stx_mode;
+            _meta.size = static_cast<ssize_t>(stx.stx_size);
+            _meta.mtime = stx.stx_mtime.tv_sec;
+            return true;
+        }
+        if (errno != ENOSYS) {
+            return false;
+        }
+        statx_supported.store(false, std::memory_order_relaxed);
+    }
+    struct stat st{};
+    if (fstatat(_dirfd, _name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+        return false;
+    }
+    _meta.valid = true;
+    _meta.mode = st.st_mode;
+    _meta.size = st.st_size;
+    _meta.mtime = st.st_mtim.tv_sec;
+    return true;
+}
+
+// One fstatat that follows the link relative to its directory. Nothing is
+// cached: the link's own inode does not change when its target is removed
+// or replaced, and checking the target costs the same fstatat again.
+static CONTENT_TYPE resolve_link_type(int _dirfd, const raw_entry &_entry) {
+    struct stat target{};
+    if (fstatat(_dirfd, _entry.name.data(), &target, 0) != 0) {
+        return CONTENT_TYPE::IS_HANGING_LINK;
+    }
+    return S_ISDIR(target.st_mode) ? CONTENT_TYPE::IS_LNK_TO_DIR : CONTENT_TYPE::IS_LNK;
+}
+
+void classify_entry(int _dirfd, const raw_entry &_entry, const entry_metadata &_meta,
+                    CONTENT_TYPE &_content_type, COLOR_INDEX &_color_index) {
+    _content_type = CONTENT_TYPE::IS_REG;
+    if ((_meta.mode & S_IFMT) == S_IFDIR) {
+        _content_type = CONTENT_TYPE::IS_DIR;
+    } else if ((_meta.mode & S_IFMT) == S_IFLNK) {
+        _content_type = resolve_link_type(_dirfd, _entry);
+    }
+    _color_index = entry_colorizer.color_for(_content_type, _meta.mode, _entry.name);
+}
+
+void format_modify_date(time_t _mtime, char *_buffer, size_t _len) {
+    struct tm tm_buf{};
+    std::strftime(_buffer, _len, "%D %H:%M", gmtime_r(&_mtime, &tm_buf));
+}
+
+void classify_by_d_type(const raw_entry &_entry, CONTENT_TYPE &_content_type, COLOR_INDEX &_color_index) {
+    entry_metadata meta;
+    if (_entry.d_type == DT_DIR) {
+        meta.mode = S_IFDIR;
+    } else if (_entry.d_type == DT_REG) {
+        meta.mode = S_IFREG;
+    }
+    classify_entry(-1, _entry, meta, _content_type, _color_index);
+    if (_entry.d_type == DT_LNK) {
+        _content_type = CONTENT_TYPE::IS_LNK;
+    }
+}
+
+static void build_entries(int _dirfd, const std::vector<raw_entry> &_entries,
+                          size_t _from, size_t _to, std::vector<info> &_content) {
+    for (size_t i = _from; i < _to; i++) {
+        entry_metadata meta;
+        if (!fetch_entry_metadata(_dirfd, _entries[i].name.data(), meta)) {
+            continue;
+        }
+        CONTENT_TYPE content_type;
+        COLOR_INDEX color_index;
+        classify_entry(_dirfd, _entries[i], meta, content_type, color_index);
+        _content.emplace_back(_entries[i].name, meta.mtime, meta.size, content_type, color_index);
+    }
+}
+
+size_t parallel_stat_workers(size_t _count) {
+    size_t workers = std::thread::hardware_concurrency();
+    if (workers < PARALLEL_STAT_MIN_THREADS) {
+        workers = PARALLEL_STAT_MIN_THREADS;
+    }
+    if (workers > PARALLEL_STAT_MAX_THREADS) {
+        workers = PARALLEL_STAT_MAX_THREADS;
+    }
+    size_t chunks = (_count + PARALLEL_STAT_CHUNK - 1) / PARALLEL_STAT_CHUNK;
+    return workers < chunks ? workers : chunks;
+}
+
+static void build_entries_parallel(int _dirfd, const std::vector<raw_entry> &_entries, listing &_content) {
+    size_t workers = parallel_stat_workers(_entries.size());
+    std::atomic<size_t> next_chunk(0);
+    std::vector<std::vector<info>> results(workers);
+    std::vector<std::thread> threads;
+    threads.reserve(workers);
+    for (size_t w = 0; w < workers; w++) {
+        threads.emplace_back([&, w]() {
+            results[w].reserve(_entries.size() / workers + PARALLEL_STAT_CHUNK);
+            size_t from;
+            while ((from = next_chunk.fetch_add(PARALLEL_STAT_CHUNK)) < _entries.size()) {
+                size_t to = std::min(from + PARALLEL_STAT_CHUNK, _entries.size());
+                build_entries(_dirfd, _entries, from, to, results[w]);
+            }
+        });
+    }
+    for (auto &&thread: threads) {
+        thread.join();
+    }
+    for (auto &&part: results) {
+        for (auto &&entry: part) {
+            _content.push_back(entry);
+        }
+    }
+}
+
+void build_directory_listing(int _dirfd, const std::vector<raw_entry> &_entries, listing &_content) {
+    _content.reserve(_entries.size());
+    if (_entries.size() < PARALLEL_STAT_THRESHOLD) {
+        std::vector<info> part;
+        part.reserve(_entries.size());
+        build_entries(_dirfd, _entries, 0, _entries.size(), part);
+        for (auto &&entry: part) {
+            _content.push_back(entry);
+        }
+    } else {
+        build_entries_parallel(_dirfd, _entries, _content);
+    }
+}
+
+bool read_directory_listing(const std::string &_path, listing &_content) {
+    int dirfd = open_directory(_path);
+    if (dirfd == -1) {
+        return false;
+    }
+    auto arena = std::make_shared<name_arena>();
+    std::vector<raw_entry> entries;
+    if (!read_directory_entries(dirfd, entries, *arena)) {
+        close(dirfd);
+        return false;
+    }
+    _content.adopt_arena(arena);
+    build_directory_listing(dirfd, entries, _content);
+    close(dirfd);
+    return true;
+}
+
+metadata_loader::metadata_loader() : cancelled(false), next_chunk(0), active_workers(0) {
+    this->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    this->dirfd = -1;
+    this->finished = false;
+    this->running = false;
+}
+
+metadata_loader::~metadata_loader() {
+    cancel();
+    close(event_fd);
+}
+
+void metadata_loader::start(int _dirfd, std::vector<raw_entry> &&_entries,
+                            std::shared_ptr<name_arena> _arena) {
+    cancel();
+    this->arena = std::move(_arena);
+    this->dirfd = _dirfd;
+    this->entries = std::move(_entries);
+    this->finished = false;
+    this->running = true;
+    cancelled.store(false);
+    next_chunk.store(0);
+    size_t workers = parallel_stat_workers(entries.size());
+    active_workers.store(workers);
+    for (size_t i = 0; i < workers; i++) {
+        threads.emplace_back(&metadata_loader::worker, this);
+    }
+}
+
+void metadata_loader::worker() {
+    size_t from;
+    while (!cancelled.load(std::memory_order_relaxed)
+           && (from = next_chunk.fetch_add(PARALLEL_STAT_CHUNK)) < entries.size()) {
+        size_t to = std::min(from + PARALLEL_STAT_CHUNK, entries.size());
+        std::vector<entry_update> updates;
+        updates.reserve(to - from);
+        for (size_t i = from; i < to; i++) {
+            entry_metadata meta;
+            entry_update update{i, fetch_entry_metadata(dirfd, entries[i].name.data(), meta),
+                                meta.size, meta.mtime, CONTENT_TYPE::IS_REG, WHITE_COLOR};
+            if (update.valid) {
+                classify_entry(dirfd, entries[i], meta, update.content_type, update.color_index);
+            }
+            updates.push_back(std::move(update));
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        std::move(updates.begin(), updates.end(), std::back_inserter(pending));
+        uint64_t one = 1;
+        (void) !write(event_fd, &one, sizeof(one));
+    }
+    if (active_workers.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = true;
+        uint64_t one = 1;
+        (void) !write(event_fd, &one, sizeof(one));
+    }
+}
+
+void metadata_loader::cancel() {
+    cancelled.store(true);
+    for (auto &&thread: threads) {
+        thread.join();
+    }
+    threads.clear();
+    if (dirfd != -1) {
+        close(dirfd);
+        dirfd = -1;
+    }
+    uint64_t value;
+    (void) !read(event_fd, &value, sizeof(value));
+    pending.clear();
+    entries.clear();
+    arena.reset();
+    running = false;
+}
+
+bool metadata_loader::take_updates(std::vector<entry_update> &_updates) {
+    if (!running) {
+        return false;
+    }
+    uint64_t value;
+    (void) !read(event_fd, &value, sizeof(value));
+    bool done;
+    _updates.clear();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        _updates.swap(pending);
+        done = finished;
+    }
+    if (done) {
+        cancel();
+    }
+    return done;
+}
+
+int metadata_loader::get_event_fd() const {
+    return event_fd;
+}
+
+bool metadata_loader::is_running() const {
+    return running;
+}
@@ -0,0 +1,82 @@
+#ifndef COURSE_PROJECT_DIR_READER_H
+#define COURSE_PROJECT_DIR_READER_H
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include "file_panel.h"
+
+#define GETDENTS_BUFFER_SIZE (1 << 20)
+#define STATX_PANEL_MASK (STATX_TYPE | STATX_SIZE | STATX_MTIME)
+#define PARALLEL_STAT_THRESHOLD 4096
+#define PARALLEL_STAT_CHUNK 1024
+#define PARALLEL_STAT_MIN_THREADS 4
+#define PARALLEL_STAT_MAX_THREADS 32
+#define PROGRESSIVE_LIST_THRESHOLD 16384
+#define DATE_BUFFER_LEN 25
+
+struct raw_entry {
+    std::string_view name;
+    unsigned char d_type;
+};
+
+struct entry_metadata {
+    bool valid = false;
+    mode_t mode = 0;
+    ssize_t size = 0;
+    time_t mtime = 0;
+};
+
+int open_directory(const std::string& _path);
+bool read_directory_entries(int _dirfd, std::vector<raw_entry>& _entries, name_arena& _arena);
+bool fetch_entry_metadata(int _dirfd, const char* _name, entry_metadata& _meta);
+void classify_entry(int _dirfd, const raw_entry& _entry, const entry_metadata& _meta,
+                    CONTENT_TYPE& _content_type, COLOR_INDEX& _color_index);
+struct entry_update {
+    size_t index;
+    bool valid;
+    ssize_t size;
+    int64_t modify_time;
+    CONTENT_TYPE content_type;
+    COLOR_INDEX color_index;
+};
+
+class metadata_loader {
+private:
+    int event_fd;
+    int dirfd;
+    std::vector<raw_entry> entries;
+    std::shared_ptr<name_arena> arena;
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::vector<entry_update> pending;
+    std::atomic<bool> cancelled;
+    std::atomic<size_t> next_chunk;
+    std::atomic<size_t> active_workers;
+    bool finished;
+    bool running;
+    void worker();
+public:
+    metadata_loader();
+    ~metadata_loader();
+    metadata_loader(const metadata_loader&) = delete;
+    metadata_loader& operator=(const metadata_loader&) = delete;
+    void start(int _dirfd, std::vector<raw_entry>&& _entries,
+               std::shared_ptr<name_arena> _arena);
+    void cancel();
+    bool take_updates(std::vector<entry_update>& _updates);
+    [[nodiscard]] int get_event_fd() const;
+    [[nodiscard]] bool is_running() const;
+};
+
+size_t parallel_stat_workers(size_t _count);
+void format_modify_date(time_t _mtime, char* _buffer, size_t _len);
+void classify_by_d_type(const raw_entry& _entry, CONTENT_TYPE& _content_type, COLOR_INDEX& _color_index);
+void build_directory_listing(int _dirfd, const std::vector<raw_entry>& _entries, listing& _content);
+bool read_directory_listing(const std::string& _path, listing& _content);
+
+#endif //COURSE_PROJECT_DIR_READER_H
@@ -1,73 +1,376 @@
 #include <cstring>
+#include <cerrno>
 #include "file_panel.h"
+#include "dir_reader.h"
+#include "listing_cache.h"
+#include "listing_sort.h"
+#include "name_index.h"
+#include "latency_trace.h"
+#include "task_runner.h"
+#include "copy_engine.h"
+#include "tree_walker.h"
+#include "uring_copy.h"
+#include "job_progress.h"
+#include "job_queue.h"
+#include "copy_verify.h"
 
 history_panel history_vec;
+size_t overlay_epoch = 0;
+static uint64_t listing_stamp_counter = 0;
 std::vector<std::pair<std::string, std::string>> help_vec{{"F2", "Deleting"}, {"F3", "Create symlink"}, {"F5", "Create dir"},
                                                      {"F6", "Create file"}, {"F7", "Rename content"}, {"F8", "Copy content"},
                                                      {"F9", "Move content"}, {"p", "Edit perms"}, {"h", "History"},
                                                      {"o", "Find utility"}, {"f", "Info mount"}, {"i", "Analyse file"},
-                                                     {"v", "Calculate size"}};
+                                                     {"v", "Calculate size"}, {"s", "Sort mode"},
+                                                     {"r", "Reverse sort"}, {"PgUp", "Previous page"},
+                                                     {"PgDn", "Next page"}, {"Home", "First entry"},
+                                                     {"End", "Last entry"}, {"g", "Go to entry / %"},
+                                                     {"/", "Quick search"}, {"l", "Latency trace"},
+                                                     {"u", "Copy backend"}, {"c", "Verify copies"},
+                                                     {"j", "Jobs"}};
 
 void file_panel::read_current_dir() {
+    scoped_span span(SPAN_KIND::LISTING);
+    loader->cancel();
+    chrome_dirty = true;
+    resort_pending = false;
+    row_texts.clear();
     if (!content.empty()) {
         content.clear();
     }
-    struct stat st{};
-    struct dirent *dir;
-    DIR *d = opendir(this->current_directory.c_str());
-    if (d == nullptr) {
+    watch_current_dir();
+    int dirfd = open_directory(current_directory);
+    if (dirfd == -1) {
         return;
     }
-    while ((dir = readdir(d))) {
-        std::string buffer(dir->d_name);
-        if (buffer == ".") {
+    if (fstat(dirfd, &listing_stat) != 0) {
+        listing_stat.st_ino = 0;
+    } else if (directory_cache.lookup(listing_stat, content, current_ind, start_index)) {
+        close(dirfd);
+        if (current_ind >= content.size()) {
+            current_ind = 0;
+            start_index = 0;
+        }
+        sort_keeping_cursor();
+        return;
+    }
+    auto arena = std::make_shared<name_arena>();
+    std::vector<raw_entry> entries;
+    if (!read_directory_entries(dirfd, entries, *arena)) {
+        close(dirfd);
+        return;
+    }
+    content.adopt_arena(arena);
+    if (entries.size() < PROGRESSIVE_LIST_THRESHOLD) {
+        build_directory_listing(dirfd, entries, content);
+        close(dirfd);
+        sort_content();
+        store_in_cache();
+        return;
+    }
+    content.reserve(entries.size());
+    for (auto &&entry: entries) {
+        CONTENT_TYPE content_type;
+        COLOR_INDEX color_index;
+        classify_by_d_type(entry, content_type, color_index);
+        content.push_back(info(entry.name, 0, -1, content_type, color_index));
+    }
+    sort_content();
+    for (size_t i = 0; i < content.size(); i++) {
+        entries[i].name = content[i].name_content;
+    }
+    loader->start(dirfd, std::move(entries), arena);
+}
+
+void file_panel::store_in_cache() {
+    if (listing_stat.st_ino != 0) {
+        directory_cache.store(listing_stat, content, current_ind, start_index);
+    }
+}
+
+// Forced re-reads (inotify overflow, an unwatched panel) must pick up changes
+// to the entries themselves, which leave the directory's own timestamps
+// alone, so they drop the cached listing instead of trusting it.
+void file_panel::reload_current_dir() {
+    struct stat st {};
+    if (stat(current_directory.c_str(), &st) == 0) {
+        directory_cache.forget(st);
+    }
+    read_current_dir();
+}
+
+void file_panel::remember_current_dir() {
+    if (loader->is_running() || content.empty() || watched_directory != current_directory) {
+        return;
+    }
+    if (stat(current_directory.c_str(), &listing_stat) != 0) {
+        return;
+    }
+    apply_fs_events();
+    if (watched_directory == current_directory) {
+        store_in_cache();
+    }
+}
+
+void file_panel::sort_content() {
+    scoped_span span(SPAN_KIND::SORT);
+    rows_dirty = true;
+    size_t slot = sort_slot(active_order);
+    if (content.restore_permutation(slot)) {
+        return;
+    }
+    content.apply_permutation(sort_permutation(content, active_order));
+    content.remember_permutation(slot);
+}
+
+void file_panel::sort_keeping_cursor() {
+    if (content.empty()) {
+        return;
+    }
+    uint32_t selected = content[current_ind].id;
+    sort_content();
+    current_ind = content.position_of(selected);
+    if (current_ind < start_index || current_ind >= start_index + LINES - 4) {
+        start_index = static_cast<int>(current_ind / (LINES - 4)) * (LINES - 4);
+    }
+}
+
+sort_order file_panel::get_sort_order() const {
+    return active_order;
+}
+
+void file_panel::set_sort_order(sort_order _order) {
+    active_order = _order;
+    chrome_dirty = true;
+    if (loader->is_running()) {
+        resort_pending = true;
+        return;
+    }
+    sort_keeping_cursor();
+}
+
+COPY_BACKEND file_panel::get_copy_backend() const {
+    return copy_backend;
+}
+
+void file_panel::set_copy_backend(COPY_BACKEND _backend) {
+    copy_backend = _backend;
+    chrome_dirty = true;
+}
+
+bool file_panel::get_verify_copies() const {
+    return verify_copies;
+}
+
+void file_panel::set_verify_copies(bool _verify) {
+    verify_copies = _verify;
+    chrome_dirty = true;
+}
+
+void file_panel::refresh_content() {
+    if (loader->is_running() || watch_descriptor == -1 || watched_directory != current_directory) {
+        std::string selected = content.empty() ? "" : std::string(content[current_ind].name_content);
+        reload_current_dir();
+        select_entry_or_clamp(selected);
+        return;
+    }
+    apply_fs_events();
+}
+
+void file_panel::watch_current_dir() {
+    if (watch_descriptor != -1) {
+        inotify_rm_watch(inotify_fd, watch_descriptor);
+        watch_descriptor = -1;
+    }
+    watched_directory = current_directory;
+    if (inotify_fd == -1) {
+        return;
+    }
+    watch_descriptor = inotify_add_watch(inotify_fd, current_directory.c_str(), INOTIFY_PANEL_MASK);
+    alignas(inotify_event) char buffer[INOTIFY_BUFFER_SIZE];
+    while (read(inotify_fd, buffer, sizeof(buffer)) > 0) {}
+}
+
+size_t file_panel::find_entry(const std::string &_name) const {
+    if (names->is_current(content) || active_order.mode != SORT_MODE::BY_NAME || active_order.reverse) {
+        return names->find(content, _name);
+    }
+    info key(_name, 0, 0, CONTENT_TYPE::IS_DIR, WHITE_COLOR);
+    for (auto type: {CONTENT_TYPE::IS_DIR, CONTENT_TYPE::IS_LNK_TO_DIR, CONTENT_TYPE::IS_LNK,
+                     CONTENT_TYPE::IS_REG, CONTENT_TYPE::IS_HANGING_LINK}) {
+        key.content_type = type;
+        auto it = std::lower_bound(content.begin(), content.end(), key,
+                                   [this](const info &_a, const info &_b) { return entry_less(_a, _b, active_order); });
+        if (it != content.end() && it->content_type == type && it->name_content == _name) {
+            return it - content.begin();
+        }
+    }
+    return std::string::npos;
+}
+
+void file_panel::select_entry_or_clamp(const std::string &_name) {
+    size_t ind = find_entry(_name);
+    if (ind != std::string::npos) {
+        current_ind = ind;
+    } else if (current_ind >= content.size()) {
+        current_ind = content.empty() ? 0 : content.size() - 1;
+    }
+    if (current_ind < start_index || current_ind >= start_index + LINES - 4) {
+        start_index = static_cast<int>(current_ind / (LINES - 4)) * (LINES - 4);
+    }
+}
+
+// _names is sorted and unique. All old entries go in one pass before any
+// insert, so a batch never looks a name up in a listing it just changed and
+// the name index is rebuilt at most once, by the caller's final lookup.
+void file_panel::update_entries(int _dirfd, const std::vector<std::string> &_names) {
+    content.erase(std::remove_if(content.begin(), content.end(), [&_names](const info &_entry) {
+        return std::binary_search(_names.begin(), _names.end(), _entry.name_content);
+    }), content.end());
+    for (auto &&name: _names) {
+        raw_entry entry{name, DT_UNKNOWN};
+        entry_metadata meta;
+        if (!fetch_entry_metadata(_dirfd, name.c_str(), meta)) {
             continue;
         }
-        std::string full_path = current_directory + "/" + buffer;
-        lstat(full_path.c_str(), &st);
-        ssize_t size = st.st_size;
-        char date[25];
-        std::strftime(date, sizeof(date), "%D %H:%M", std::gmtime(&st.st_mtim.tv_sec));
         CONTENT_TYPE content_type;
         COLOR_INDEX color_index;
-        if ((st.st_mode & S_IFMT) == S_IFDIR) {
-            content_type = CONTENT_TYPE::IS_DIR;
-            color_index = MAGENTA_COLOR;
-        } else if ((st.st_mode & S_IFMT) == S_IFLNK) {
-            std::filesystem::path link_p(full_path);
-            std::filesystem::path link_target = std::filesystem::read_symlink(link_p);
-            if (!std::filesystem::exists(link_target)) {
-                content_type = CONTENT_TYPE::IS_HANGING_LINK;
-                color_index = RED_COLOR;
-            }
-            else if (is_symlink(link_p) && is_directory(link_p)) {
-                content_type = CONTENT_TYPE::IS_LNK_TO_DIR;
-                color_index = MAGENTA_COLOR;
-            } else {
-                content_type = CONTENT_TYPE::IS_LNK;
-                color_index = WHITE_COLOR;
-            }
-        } else if ((st.st_mode & S_IFMT) == S_IFREG) {
-            content_type = CONTENT_TYPE::IS_REG;
-            std::filesystem::path reg_path(full_path);
-            std::filesystem::path p = reg_path.extension();
-            if (p == ".tmp") {
-                color_index = BLUE_COLOR;
-            } else if (p == ".txt") {
-                color_index = YELLOW_COLOR;
-            } else if (p == ".c" || p == ".cpp" || p == ".h" || p == ".hpp") {
-                color_index = GREEN_COLOR;
-            } else color_index = WHITE_COLOR;
-         }
-        content.emplace_back(buffer, date, size, content_type, color_index);
-    }
-    std::sort(content.begin(), content.end(),
-              [](const info &first, const info &second) {
-                  if (first.content_type != second.content_type) {
-                      return first.content_type < second.content_type;
-                  }
-                  return first.name_content < second.name_content;
-              });
+        classify_entry(_dirfd, entry, meta, content_type, color_index);
+        info new_entry(content.intern(name), meta.mtime, meta.size, content_type, color_index);
+        content.insert(std::upper_bound(content.begin(), content.end(), new_entry,
+                                        [this](const info &_a, const info &_b) { return entry_less(_a, _b, active_order); }),
+                       std::move(new_entry));
+    }
+}
+
+bool file_panel::apply_fs_events() {
+    if (watch_descriptor == -1) {
+        return false;
+    }
+    alignas(inotify_event) char buffer[INOTIFY_BUFFER_SIZE];
+    std::vector<std::string> names;
+    bool overflow = false;
+    bool directory_gone = false;
+    ssize_t len;
+    while ((len = read(inotify_fd, buffer, sizeof(buffer))) > 0) {
+        for (char *ptr = buffer; ptr < buffer + len;) {
+            auto *event = reinterpret_cast<inotify_event *>(ptr);
+            ptr += sizeof(inotify_event) + event->len;
+            if (event->mask & IN_Q_OVERFLOW) {
+                overflow = true;
+            } else if (event->wd != watch_descriptor) {
+                continue;
+            } else if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) {
+                directory_gone = true;
+            } else if (event->len > 0) {
+                names.emplace_back(event->name);
+            }
+        }
+    }
+    std::string selected = content.empty() ? "" : std::string(content[current_ind].name_content);
+    if (directory_gone) {
+        std::filesystem::path new_path(current_directory);
+        while (!exists(new_path) && new_path.has_parent_path() && new_path != new_path.parent_path()) {
+            new_path = new_path.parent_path();
+        }
+        current_directory = new_path.string();
+        current_ind = 0;
+        start_index = 0;
+        read_current_dir();
+        return true;
+    }
+    if (overflow) {
+        reload_current_dir();
+        select_entry_or_clamp(selected);
+        return true;
+    }
+    if (names.empty()) {
+        return false;
+    }
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+    int dirfd = open_directory(current_directory);
+    if (dirfd == -1) {
+        return false;
+    }
+    update_entries(dirfd, names);
+    close(dirfd);
+    content.compact();
+    content.remember_permutation(sort_slot(active_order));
+    select_entry_or_clamp(selected);
+    rows_dirty = true;
+    return true;
+}
+
+void file_panel::collect_poll_fds(std::vector<pollfd> &_fds) const {
+    if (loader->is_running()) {
+        _fds.push_back({loader->get_event_fd(), POLLIN, 0});
+    } else if (watch_descriptor != -1) {
+        _fds.push_back({inotify_fd, POLLIN, 0});
+    }
+}
+
+bool file_panel::process_events() {
+    if (!loader->is_running()) {
+        return apply_fs_events();
+    }
+    std::vector<entry_update> updates;
+    bool done = loader->take_updates(updates);
+    if (!updates.empty()) {
+        content.invalidate_permutations();
+    }
+    for (auto &&update: updates) {
+        info &entry = content[update.index];
+        mark_row_dirty(update.index);
+        row_texts.invalidate(entry.id);
+        if (!update.valid) {
+            entry.size_content = -2;
+            continue;
+        }
+        if (entry.content_type != update.content_type) {
+            resort_pending = true;
+        }
+        entry.size_content = update.size;
+        entry.modify_time = update.modify_time;
+        entry.content_type = update.content_type;
+        entry.color_index = update.color_index;
+    }
+    if (done) {
+        std::string selected = content.empty() ? "" : std::string(content[current_ind].name_content);
+        size_t old_size = content.size();
+        content.erase(std::remove_if(content.begin(), content.end(),
+                                     [](const info &entry) { return entry.size_content == -2; }),
+                      content.end());
+        if (resort_pending || old_size != content.size()
+            || active_order.mode == SORT_MODE::BY_SIZE || active_order.mode == SORT_MODE::BY_MTIME) {
+            resort_pending = false;
+            sort_content();
+            size_t ind = find_entry(selected);
+            current_ind = ind == std::string::npos ? 0 : ind;
+            start_index = static_cast<int>(current_ind / (LINES - 4)) * (LINES - 4);
+        } else {
+            content.remember_permutation(sort_slot(active_order));
+        }
+        store_in_cache();
+    }
+    return !updates.empty() || done;
+}
+
+void file_panel::resolve_pending_entry(size_t _ind) {
+    if (content[_ind].size_content >= 0) {
+        return;
+    }
+    int dirfd = open_directory(current_directory);
+    if (dirfd == -1) {
+        return;
+    }
+    raw_entry entry{content[_ind].name_content, DT_UNKNOWN};
+    entry_metadata meta;
+    if (fetch_entry_metadata(dirfd, entry.name.data(), meta)) {
+        classify_entry(dirfd, entry, meta, content[_ind].content_type, content[_ind].color_index);
+        row_texts.invalidate(content[_ind].id);
+    }
+    close(dirfd);
 }
 
 file_panel::file_panel(std::string_view _current_directory, size_t _rows, size_t _cols, size_t _x, size_t _y) {
@@ -78,24 +381,50 @@ file_panel::file_panel(std::string_view _current_directory, size_t _rows, size_t
     this->win = newwin(static_cast<int>(_rows), static_cast<int>(_cols),
                        static_cast<int>(_x), static_cast<int>(_y));
     this->panel = new_panel(win);
+    this->loader = std::make_unique<metadata_loader>();
+    this->names = std::make_unique<name_index>();
+    this->searching = false;
+    this->status_dirty = false;
+    this->resort_pending = false;
+    this->active_order = sort_order();
+    this->copy_backend = default_copy_backend();
+    this->verify_copies = false;
+    this->listing_stat = {};
+    this->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    this->watch_descriptor = -1;
+    this->chrome_dirty = true;
+    this->rows_dirty = true;
+    this->drawn_epoch = overlay_epoch;
+    this->drawn_active = false;
+    this->drawn_start = 0;
+    this->drawn_cursor = 0;
+    this->drawn_count = 0;
+    this->drawn_trace = false;
     keypad(this->win, true);
     read_current_dir();
-    update_panels();
-    doupdate();
 }
 
 void file_panel::display_lines() {
     if (active_panel) {
         wattron(win, COLOR_PAIR(1));
     }
-    for (size_t i = 1; i < LINES - 2; i++) {
-        mvwaddch(win, i, COLS / 2 - DATE_LEN, ACS_VLINE);
-        mvwaddch(win, i, COLS / 2 - DATE_LEN - MAX_SIZE_LEN, ACS_VLINE);
-    }
+    mvwvline(win, 1, COLS / 2 - DATE_LEN, ACS_VLINE, LINES - 3);
+    mvwvline(win, 1, COLS / 2 - DATE_LEN - MAX_SIZE_LEN, ACS_VLINE, LINES - 3);
     wattroff(win, COLOR_PAIR(1));
 }
 
 void file_panel::display_content() {
+    chrome_dirty = true;
+    render();
+}
+
+void file_panel::mark_row_dirty(size_t _ind) {
+    if (_ind >= start_index && _ind < start_index + LINES - 4) {
+        dirty_rows.push_back(_ind);
+    }
+}
+
+void file_panel::render() {
     if (COLS < 66) {
         std::string message = "Terminal too narrow to show contents";
         create_error_panel(" Window size error ", message,
@@ -104,93 +433,148 @@ void file_panel::display_content() {
         endwin();
         exit(-1);
     }
-    werase(win);
-    refresh();
-    display_box();
-    display_lines();
-    display_headers();
-    display_current_dir();
-    size_t ind_offset = 2;
-    for (size_t i = this->start_index; i < content.size() && i < LINES - 4 + this->start_index; i++) {
-        if (active_panel) {
-            attron(A_BOLD | COLOR_PAIR(10));
-            mvprintw(LINES - 1, 0, "%*s", COLS, " ");
-            int weight_line = COLS - 29;
-            std::string current_path = current_directory + "/" + content[current_ind].name_content;
-            std::string final_str;
-            if (current_path.length() > weight_line) {
-                convert_str_to_window_size(final_str, current_path, weight_line);
-            } else {
-                final_str = current_path;
-            }
-            mvprintw(LINES - 1, 0, "%s%zu%s%zu%s%s", "File:     ",
-                     current_ind + 1, " of ", content.size(), "     Path: ",
-                     final_str.c_str());
-            attroff(A_BOLD | COLOR_PAIR(10));
-        }
-        if (i == current_ind && active_panel) {
-            wattron(win, A_REVERSE);
-        }
-        mvwprintw(win, static_cast<int>(ind_offset), 1, "%*s", (COLS / 2) - 2, " ");
-
-        if (((current_ind != ind_offset - 2 + start_index) || !active_panel)) {
-            wattron(win, COLOR_PAIR(content[i].color_index));
-        }
-        std::string output_string = content[i].name_content;
-        convert_to_output(output_string, content[i].content_type);
-        size_t len_line = COLS / 2 - DATE_LEN - MAX_SIZE_LEN - 1;
-        //? maybe create error if panel resize < 5
-        if (len_line < output_string.length()) {
-            std::string short_str;
-            convert_str_to_window_size(short_str, output_string, len_line);
-            mvwprintw(win, static_cast<int>(ind_offset), 1, "%s", short_str.c_str());
-        } else {
-            mvwprintw(win, static_cast<int>(ind_offset), 1, "%s",
-                      output_string.c_str());
+    if (drawn_epoch != overlay_epoch || drawn_active != active_panel) {
+        chrome_dirty = true;
+    }
+    if (chrome_dirty || drawn_start != start_index || drawn_count != content.size()) {
+        rows_dirty = true;
+    }
+    if (active_panel && (ui_tracer.overlay_visible() || drawn_trace)) {
+        status_dirty = true;
+    }
+    bool cursor_moved = drawn_cursor != current_ind;
+    if (!rows_dirty && !cursor_moved && !status_dirty && dirty_rows.empty()) {
+        return;
+    }
+    scoped_span span(SPAN_KIND::RENDER);
+    if (chrome_dirty) {
+        werase(win);
+        display_box();
+        display_lines();
+        display_headers();
+        display_current_dir();
+    }
+    if (rows_dirty) {
+        for (size_t row = 0; row < static_cast<size_t>(LINES - 4); row++) {
+            display_row(row);
         }
+    } else {
+        if (cursor_moved) {
+            mark_row_dirty(drawn_cursor);
+            mark_row_dirty(current_ind);
+        }
+        for (auto &&ind: dirty_rows) {
+            display_row(ind - start_index);
+        }
+    }
+    if (active_panel && !content.empty()) {
+        display_status();
+    }
+    dirty_rows.clear();
+    chrome_dirty = false;
+    rows_dirty = false;
+    status_dirty = false;
+    drawn_trace = ui_tracer.overlay_visible();
+    drawn_epoch = overlay_epoch;
+    drawn_active = active_panel;
+    drawn_start = start_index;
+    drawn_cursor = current_ind;
+    drawn_count = content.size();
+    refresh_panels();
+}
 
-        wattroff(win, COLOR_PAIR(3));
+void file_panel::display_status() {
+    attron(A_BOLD | COLOR_PAIR(10));
+    mvprintw(LINES - 1, 0, "%*s", COLS, " ");
+    if (searching) {
+        mvprintw(LINES - 1, 0, "%s%s%s%zu%s%zu", "Search:   ", search_prefix.c_str(),
+                 "     File: ", current_ind + 1, " of ", content.size());
+        attroff(A_BOLD | COLOR_PAIR(10));
+        return;
+    }
+    if (ui_tracer.overlay_visible()) {
+        mvprintw(LINES - 1, 0, "%s%zu%s%zu%s%s", "File:     ",
+                 current_ind + 1, " of ", content.size(), "     Latency: ",
+                 ui_tracer.summary().c_str());
+        attroff(A_BOLD | COLOR_PAIR(10));
+        return;
+    }
+    int weight_line = COLS - 29;
+    std::string current_path = current_directory + "/" + std::string(content[current_ind].name_content);
+    std::string final_str;
+    if (current_path.length() > weight_line) {
+        convert_str_to_window_size(final_str, current_path, weight_line);
+    } else {
+        final_str = current_path;
+    }
+    mvprintw(LINES - 1, 0, "%s%zu%s%zu%s%s", "File:     ",
+             current_ind + 1, " of ", content.size(), "     Path: ",
+             final_str.c_str());
+    attroff(A_BOLD | COLOR_PAIR(10));
+}
 
-        if (active_panel && ind_offset - 2 + start_index != current_ind) {
+void file_panel::display_row(size_t _row) {
+    size_t ind_offset = _row + 2;
+    size_t i = start_index + _row;
+    if (i >= content.size()) {
+        mvwprintw(win, static_cast<int>(ind_offset), 1, "%*s", (COLS / 2) - 2, " ");
+        if (active_panel) {
             wattron(win, COLOR_PAIR(1));
         }
-
-        mvwaddch(win, ind_offset, COLS / 2 - DATE_LEN, ACS_VLINE);
         mvwaddch(win, ind_offset, COLS / 2 - DATE_LEN, ACS_VLINE);
         mvwaddch(win, ind_offset, COLS / 2 - DATE_LEN - MAX_SIZE_LEN, ACS_VLINE);
-
         wattroff(win, COLOR_PAIR(1));
+        return;
+    }
+    if (i == current_ind && active_panel) {
+        wattron(win, A_REVERSE);
+    }
+    mvwprintw(win, static_cast<int>(ind_offset), 1, "%*s", (COLS / 2) - 2, " ");
+
+    if (((current_ind != ind_offset - 2 + start_index) || !active_panel)) {
+        wattron(win, COLOR_PAIR(content[i].color_index));
+    }
+    size_t len_line = COLS / 2 - DATE_LEN - MAX_SIZE_LEN - 1;
+    //? maybe create error if panel resize < 5
+    const row_text &text = row_texts.get(_row, content[i], len_line);
+    mvwprintw(win, static_cast<int>(ind_offset), 1, "%s", text.name.c_str());
 
-        std::string size_str = std::to_string(content[i].size_content);
+    wattroff(win, COLOR_PAIR(3));
 
+    if (active_panel && ind_offset - 2 + start_index != current_ind) {
+        wattron(win, COLOR_PAIR(1));
+    }
 
-        mvwprintw(win, static_cast<int>(ind_offset),
-                  (COLS / 2) - DATE_LEN - static_cast<int>(size_str.length()),
-                  "%s", size_str.c_str());
+    mvwaddch(win, ind_offset, COLS / 2 - DATE_LEN, ACS_VLINE);
+    mvwaddch(win, ind_offset, COLS / 2 - DATE_LEN - MAX_SIZE_LEN, ACS_VLINE);
 
-        mvwprintw(win, static_cast<int>(ind_offset),
-                  (COLS / 2) - DATE_LEN + 1,
-                  "%s", content[i].last_redact_content.c_str());
+    wattroff(win, COLOR_PAIR(1));
 
-        wattroff(win, A_REVERSE);
+    mvwprintw(win, static_cast<int>(ind_offset),
+              (COLS / 2) - DATE_LEN - text.size_len,
+              "%s", text.size);
 
-        ind_offset++;
+    char date[DATE_BUFFER_LEN] = "";
+    if (content[i].size_content >= 0) {
+        format_modify_date(static_cast<time_t>(content[i].modify_time), date, sizeof(date));
     }
-    refresh_panels();
+    mvwprintw(win, static_cast<int>(ind_offset),
+              (COLS / 2) - DATE_LEN + 1,
+              "%s", date);
+
+    wattroff(win, A_REVERSE);
 }
 
 void file_panel::resize_panel(size_t _rows, size_t _cols, size_t _x, size_t _y) {
+    chrome_dirty = true;
     start_index = static_cast<int>(current_ind / (LINES - 4)) * (LINES - 4);
     werase(win);
     wresize(win, static_cast<int>(_rows), static_cast<int>(_cols));
     mvwin(win, static_cast<int>(_x), static_cast<int>(_y));
-    wrefresh(win);
-    refresh();
 }
 
 void file_panel::refresh_panels() {
-    wrefresh(win);
-    refresh();
+    update_panels();
 }
 
 PANEL *file_panel::get_panel() const {
@@ -198,14 +582,27 @@ PANEL *file_panel::get_panel() const {
 }
 
 void file_panel::display_headers() {
+    std::string header_name = HEADER_NAME;
+    if (active_order.mode != SORT_MODE::BY_NAME || active_order.reverse) {
+        header_name += std::string(" [") + sort_mode_label(active_order.mode)
+                       + (active_order.reverse ? " desc]" : "]");
+    }
+    if (copy_backend != COPY_BACKEND::SYSCALL) {
+        header_name += std::string(" [") + copy_backend_label(copy_backend) + "]";
+    }
+    if (verify_copies) {
+        header_name += " [verify]";
+    }
     wattron(win, A_BOLD);
-    mvwprintw(win, 1, (((COLS / 2) - DATE_LEN - MAX_SIZE_LEN) / 2) - 1, "%s", HEADER_NAME);
+    mvwprintw(win, 1, (((COLS / 2) - DATE_LEN - MAX_SIZE_LEN) / 2) - 1 - static_cast<int>(header_name.size() / 2)
+                      + static_cast<int>(strlen(HEADER_NAME) / 2), "%s", header_name.c_str());
     mvwprintw(win, 1, (COLS / 2) - DATE_LEN - MAX_SIZE_LEN + 4, "%s", HEADER_SIZE);
     mvwprintw(win, 1, (COLS / 2) - DATE_LEN + 3, "%s", HEADER_MODIFY_DATE);
     wattroff(win, A_BOLD);
 }
 
 void file_panel::switch_directory(const std::string &_direction) {
+    resolve_pending_entry(current_ind);
     if (content[current_ind].content_type == CONTENT_TYPE::IS_LNK_TO_DIR
     || content[current_ind].content_type == CONTENT_TYPE::IS_DIR) {
         DIR *d;
@@ -237,11 +634,16 @@ void file_panel::switch_directory(const std::string &_direction) {
                                message, 8,
                                WEIGHT_FUNCTIONAL_PANEL > message.length()
                                ? WEIGHT_FUNCTIONAL_PANEL : message.length() + 2);
+            if (d != nullptr) {
+                closedir(d);
+            }
             return;
         }
         if (d == nullptr) {
             return;
         }
+        closedir(d);
+        remember_current_dir();
         start_index = 0;
         current_ind = 0;
         auto it = std::find(history_vec.history_path.begin(),
@@ -264,12 +666,18 @@ void file_panel::switch_directory(const std::string &_direction) {
 }
 
 file_panel::~file_panel() {
+    if (inotify_fd != -1) {
+        close(inotify_fd);
+    }
     del_panel(panel);
     delwin(win);
     content.clear();
 }
 
 void file_panel::move_cursor_and_pagination(size_t _direction) {
+    if (jump_pagination(_direction, LINES - 4, content.size(), start_index, current_ind)) {
+        return;
+    }
     if (_direction == KEY_UP) {
         if (current_ind == 0) {
             this->start_index = 0;
@@ -289,7 +697,66 @@ void file_panel::move_cursor_and_pagination(size_t _direction) {
     }
 }
 
-const std::vector<info> &file_panel::get_content() const {
+void file_panel::jump_to(size_t _ind) {
+    if (!content.empty()) {
+        jump_to_index(_ind, LINES - 4, content.size(), start_index, current_ind);
+    }
+}
+
+void file_panel::go_to_entry() {
+    if (content.empty()) {
+        return;
+    }
+    size_t ind;
+    if (prompt_jump_target(content.size(), ind)) {
+        jump_to(ind);
+    }
+}
+
+void file_panel::start_quick_search() {
+    searching = true;
+    search_prefix.clear();
+    status_dirty = true;
+}
+
+bool file_panel::is_quick_searching() const {
+    return searching;
+}
+
+bool file_panel::quick_search_key(int _ch) {
+    if (_ch == 27 || _ch == '\n') {
+        searching = false;
+        status_dirty = true;
+        return true;
+    }
+    if (_ch == KEY_BACKSPACE || _ch == 127 || _ch == '\b') {
+        if (!search_prefix.empty()) {
+            search_prefix.pop_back();
+            size_t ind = names->find_prefix(content, search_prefix);
+            if (ind != std::string::npos) {
+                jump_to(ind);
+            }
+            status_dirty = true;
+        }
+        return true;
+    }
+    if (_ch < ' ' || _ch > 0xff) {
+        searching = false;
+        status_dirty = true;
+        return false;
+    }
+    search_prefix.push_back(static_cast<char>(_ch));
+    size_t ind = names->find_prefix(content, search_prefix);
+    if (ind == std::string::npos) {
+        search_prefix.pop_back();
+        return true;
+    }
+    jump_to(ind);
+    status_dirty = true;
+    return true;
+}
+
+const listing &file_panel::get_content() const {
     return content;
 }
 
@@ -328,7 +795,8 @@ void file_panel::display_box() {
 }
 
 void file_panel::rename_content(file_panel &_other_panel) {
-    std::string new_name = content[current_ind].name_content;
+    scoped_span span(SPAN_KIND::FILE_OP);
+    std::string new_name = std::string(content[current_ind].name_content);
     bool flag_entry;
     if (new_name != "/..") {
         flag_entry = create_redact_other_func_panel(HEADER_RENAME, "Rename '"
@@ -344,7 +812,7 @@ void file_panel::rename_content(file_panel &_other_panel) {
                 display_content();
                 _other_panel.display_content();
                 std::string message =
-                        "Cannot rename file/dir :: '" + content[current_ind].name_content + "' to '" + new_name + "'";
+                        "Cannot rename file/dir :: '" + std::string(content[current_ind].name_content) + "' to '" + new_name + "'";
                 create_error_panel(" Permission error ", message,
                                    HEIGHT_FUNCTIONAL_PANEL - 2,
                                    WEIGHT_FUNCTIONAL_PANEL > message.length() ? WEIGHT_FUNCTIONAL_PANEL :
@@ -365,9 +833,10 @@ void file_panel::rename_content(file_panel &_other_panel) {
                             generate_incompatible_error(e);
                         }
                     }
-                    read_current_dir();
+                    refresh_content();
+                    select_entry_or_clamp(new_name);
                     if (_other_panel.current_directory == current_directory) {
-                        _other_panel.read_current_dir();
+                        _other_panel.refresh_content();
                     }
                 } else {
                     display_content();
@@ -384,6 +853,7 @@ void file_panel::rename_content(file_panel &_other_panel) {
 }
 
 void file_panel::create_directory(file_panel &_other_panel) {
+    scoped_span span(SPAN_KIND::FILE_OP);
     std::string name_directory;
     bool entry_flag = create_redact_other_func_panel(HEADER_CREATE_DIR,
                                                      DESCRIPTION_DIRECTORY,
@@ -406,19 +876,10 @@ void file_panel::create_directory(file_panel &_other_panel) {
             if (!exists(dir_path / name_directory)) {
                 std::filesystem::create_directory(dir_path / name_directory);
                 if (_other_panel.current_directory == this->current_directory) {
-                    _other_panel.read_current_dir();
-                }
-                read_current_dir();
-                size_t i = 0;
-                const auto& vec = this->get_content();
-                for (auto && it : vec) {
-                    if (it.name_content == name_directory) {
-                        this->set_current_ind(i);
-                        this->set_start_ind(static_cast<int>(i / (LINES - 4)) * (LINES - 4));
-                        break;
-                    }
-                    i++;
+                    _other_panel.refresh_content();
                 }
+                refresh_content();
+                select_entry_or_clamp(name_directory);
             } else {
                 display_content();
                 _other_panel.display_content();
@@ -432,6 +893,7 @@ void file_panel::create_directory(file_panel &_other_panel) {
 }
 
 void file_panel::create_file(file_panel &_other_panel) {
+    scoped_span span(SPAN_KIND::FILE_OP);
     std::string name_file;
     bool entry_flag = create_redact_other_func_panel(HEADER_CREATE_FILE,
                                                      DESCRIPTION_FILE,
@@ -455,19 +917,10 @@ void file_panel::create_file(file_panel &_other_panel) {
                 std::ofstream newFile(dir_path / name_file);
                 newFile.close();
                 if (_other_panel.current_directory == this->current_directory) {
-                    _other_panel.read_current_dir();
-                }
-                read_current_dir();
-                size_t i = 0;
-                const auto& vec = this->get_content();
-                for (auto && it : vec) {
-                    if (it.name_content == name_file) {
-                        this->set_current_ind(i);
-                        this->set_start_ind(static_cast<int>(i / (LINES - 4)) * (LINES - 4));
-                        break;
-                    }
-                    i++;
+                    _other_panel.refresh_content();
                 }
+                refresh_content();
+                select_entry_or_clamp(name_file);
             } else {
                 display_content();
                 _other_panel.display_content();
@@ -482,8 +935,9 @@ void file_panel::create_file(file_panel &_other_panel) {
 }
 
 void file_panel::create_symlink(file_panel &_other_panel) {
+    scoped_span span(SPAN_KIND::FILE_OP);
     std::string namelink;
-    std::string pointing_to = _other_panel.content[_other_panel.current_ind].name_content;
+    std::string pointing_to = std::string(_other_panel.content[_other_panel.current_ind].name_content);
     bool entry_flag = symlink_hardlink_func_panel(HEADER_CREATE_SYMLINK, namelink, pointing_to,
                                                   HEIGHT_FUNCTIONAL_PANEL, WEIGHT_FUNCTIONAL_PANEL);
 
@@ -509,19 +963,10 @@ void file_panel::create_symlink(file_panel &_other_panel) {
                     std::filesystem::create_symlink(other_panel_path / pointing_to, dir_path / namelink);
                 }
                 if (_other_panel.current_directory == this->current_directory) {
-                    _other_panel.read_current_dir();
-                }
-                size_t i = 0;
-                const std::vector<info>& vec = this->get_content();
-                this->read_current_dir();
-                for (auto && it : vec) {
-                    if (it.name_content == namelink) {
-                        this->set_current_ind(i);
-                        this->set_start_ind(static_cast<int>(i / (LINES - 4)) * (LINES - 4));
-                        break;
-                    }
-                    i++;
+                    _other_panel.refresh_content();
                 }
+                this->refresh_content();
+                select_entry_or_clamp(namelink);
             }
         }
     }
@@ -529,13 +974,14 @@ void file_panel::create_symlink(file_panel &_other_panel) {
 }
 
 void file_panel::copy_content(file_panel &_other_panel) {
+    scoped_span span(SPAN_KIND::FILE_OP);
     if (content[current_ind].name_content != "/..") {
         std::string path = _other_panel.current_directory;
-        bool entry_flag = create_redact_other_func_panel(HEADER_COPY, "Copy '" + content[current_ind]
-                                                                 .name_content + "' to::", path,
+        bool entry_flag = create_redact_other_func_panel(HEADER_COPY, "Copy '" + std::string(content[current_ind]
+                                                                 .name_content) + "' to::", path,
                                                          HEIGHT_FUNCTIONAL_PANEL, WEIGHT_FUNCTIONAL_PANEL);
         if (entry_flag) {
-            std::filesystem::path copy_path_from(current_directory + "/" + content[current_ind].name_content);
+            std::filesystem::path copy_path_from(current_directory + "/" + std::string(content[current_ind].name_content));
             std::filesystem::path copy_path_to(path);
             std::filesystem::path copy_to_full(copy_path_to / content[current_ind].name_content);
             if (!exists(copy_path_to)) {
@@ -604,11 +1050,11 @@ void file_panel::copy_content(file_panel &_other_panel) {
                         //try catch exist
                     if (content[current_ind].content_type == CONTENT_TYPE::IS_LNK_TO_DIR) {
                         std::filesystem::copy_symlink(copy_path_from, copy_path_to / content[current_ind].name_content);
+                        if (path == _other_panel.current_directory) {
+                            _other_panel.refresh_content();
+                        }
                     } else {
-                        overwrite_content_copy(_other_panel, copy_path_from, copy_path_to, false);
-                    }
-                    if (path == _other_panel.current_directory) {
-                        _other_panel.read_current_dir();
+                        start_copy_tree(_other_panel, copy_path_from, copy_path_to, false);
                     }
                     return;
                 } else {
@@ -633,15 +1079,15 @@ void file_panel::copy_content(file_panel &_other_panel) {
                         && (type == REMOVE_TYPE::REMOVE_ALL || type == REMOVE_TYPE::REMOVE_THIS)) {
                         std::filesystem::remove(copy_to_full);
                         std::filesystem::copy_symlink(copy_path_from, copy_to_full);
-                        _other_panel.read_current_dir();
+                        _other_panel.refresh_content();
                         return;
                     }
                     if (type == REMOVE_TYPE::REMOVE_ALL) {
-                        overwrite_content_copy(_other_panel, copy_path_from, copy_path_to, true);
+                        start_copy_tree(_other_panel, copy_path_from, copy_path_to, true);
                     } else if (type == REMOVE_TYPE::SKIP || type == REMOVE_TYPE::STOP_REMOVE) {
                         return;
                     } else {
-                        overwrite_content_copy(_other_panel, copy_path_from, copy_path_to, false);
+                        start_copy_tree(_other_panel, copy_path_from, copy_path_to, false);
                     }
                 }
                 return;
@@ -669,18 +1115,19 @@ void file_panel::copy_content(file_panel &_other_panel) {
                         std::filesystem::remove(copy_to_full);
                         std::filesystem::copy_symlink(copy_path_from, copy_path_to / content[current_ind].name_content);
                         if (copy_path_to == _other_panel.current_directory) {
-                            _other_panel.read_current_dir();
+                            _other_panel.refresh_content();
                         }
                     }
                     std::filesystem::copy_symlink(copy_path_from, copy_path_to / content[current_ind].name_content);
-                    _other_panel.read_current_dir();
+                    _other_panel.refresh_content();
                 } else if (is_character_file(copy_path_from)
                            || is_regular_file(copy_path_from)
                            || is_block_file(copy_path_from)
                            || is_fifo(copy_path_from)
                            || is_socket(copy_path_from)) {
                     if (!exists(copy_to_full)) {
-                        std::filesystem::copy_file(copy_path_from, copy_to_full);
+                        start_copy_file(_other_panel, copy_path_from, copy_to_full,
+                                        std::filesystem::copy_options::none);
                     } else {
                         display_content();
                         _other_panel.display_content();
@@ -689,13 +1136,10 @@ void file_panel::copy_content(file_panel &_other_panel) {
                                                                WEIGHT_FUNCTIONAL_PANEL > message.length()
                                                                ? WEIGHT_FUNCTIONAL_PANEL : message.length() + 2);
                         if (type == REMOVE_TYPE::REMOVE_ALL || type == REMOVE_TYPE::REMOVE_THIS) {
-                            std::filesystem::copy_file(copy_path_from, copy_to_full,
-                                                       std::filesystem::copy_options::overwrite_existing);
+                            start_copy_file(_other_panel, copy_path_from, copy_to_full,
+                                            std::filesystem::copy_options::overwrite_existing);
                         }
                     }
-                    if (copy_path_to == _other_panel.current_directory) {
-                        _other_panel.read_current_dir();
-                    }
                 }
             } catch (std::filesystem::filesystem_error& e) {
                 display_content();
@@ -711,111 +1155,242 @@ void file_panel::copy_content(file_panel &_other_panel) {
     }
 }
 
-void file_panel::overwrite_content_copy(file_panel &_other_panel, std::filesystem::path &_from, std::filesystem::path &_to, bool _all) {
-    bool overwrite_other = _all;
-    REMOVE_TYPE type;
-    std::stack<std::filesystem::path> dir_stack;
-    dir_stack.push(_from);
-    if (!exists((_to / content[current_ind].name_content))) {
-        std::filesystem::create_directory(_to / content[current_ind].name_content);
+void file_panel::start_copy_tree(file_panel &_other_panel, const std::filesystem::path &_from,
+                                 const std::filesystem::path &_to, bool _all) {
+    std::string name(content[current_ind].name_content);
+    COPY_BACKEND backend = copy_backend;
+    std::shared_ptr<job_progress> job = job_board.begin(JOB_KIND::COPY, name, _from, {_from, _to});
+    if (verify_copies) {
+        job->enable_verify();
     }
-    size_t index = _from.string().rfind(content[current_ind].name_content);
-    while (!dir_stack.empty()) {
-        std::filesystem::path current_path = dir_stack.top();
-        dir_stack.pop();
-        for (const auto &entry: std::filesystem::directory_iterator(current_path, std::filesystem::directory_options::skip_permission_denied)) {
-            std::string path_string = entry.path().string();
-            std::filesystem::path copy_part(path_string.substr(index));
-            bool flag_skip = false;
-            std::filesystem::path full_copy_path = _to / copy_part;
-            try {
-                if (!exists(full_copy_path)) {
-                    if (entry.is_directory()) {
-                        if (entry.is_symlink()) {
-                            std::filesystem::copy_symlink(entry.path(), full_copy_path);
-                        } else {
-                            std::filesystem::create_directory(full_copy_path);
-                        }
-                    } else if (entry.is_symlink()) {
+    file_jobs.submit(job, [this, &_other_panel, _from, _to, name, _all, backend, job]() {
+        try {
+            overwrite_content_copy(_other_panel, _from, _to, name, _all, backend, *job);
+        } catch (std::filesystem::filesystem_error &e) {
+            report_filesystem_error(*this, _other_panel, e);
+        }
+    }, [this, &_other_panel, _to, job]() {
+        refresh_if_showing(_other_panel, _to.string());
+        report_mismatches(*job);
+    });
+}
+
+void file_panel::start_copy_file(file_panel &_other_panel, const std::filesystem::path &_from,
+                                 const std::filesystem::path &_to, std::filesystem::copy_options _options) {
+    std::shared_ptr<job_progress> job = job_board.begin(JOB_KIND::COPY, _from.filename().string(), _from,
+                                                        {_from, _to.parent_path()});
+    if (verify_copies) {
+        job->enable_verify();
+    }
+    file_jobs.submit(job, [this, &_other_panel, _from, _to, _options, job]() {
+        try {
+            bool check = job->is_verifying() && std::filesystem::is_regular_file(_from);
+            uint32_t checksum = 0;
+            uint64_t written = 0;
+            if (copy_file_native(_from, _to, _options, &written, job->get_byte_counter(),
+                                 check ? &checksum : nullptr) != COPY_METHOD::NONE) {
+                job->add_files(1);
+                job->add_written(written);
+                if (check) {
+                    copy_verifier verifier([job]() {
+                        job->add_verified(1);
+                    }, [job](const std::filesystem::path &_to, const std::string &_reason) {
+                        job->add_mismatch(_to.string() + ": " + _reason);
+                    });
+                    verifier.add(_to, checksum);
+                }
+            }
+        } catch (std::filesystem::filesystem_error &e) {
+            report_filesystem_error(*this, _other_panel, e);
+        }
+    }, [this, &_other_panel, _to, job]() {
+        refresh_if_showing(_other_panel, _to.parent_path().string());
+        report_mismatches(*job);
+    });
+}
+
+void file_panel::report_mismatches(const job_progress &_job) {
+    std::vector<std::string> mismatches = _job.get_mismatches();
+    if (!mismatches.empty()) {
+        display_content();
+        create_verify_panel(mismatches);
+    }
+}
+
+void file_panel::refresh_if_showing(file_panel &_other_panel, const std::string &_directory) {
+    if (current_directory == _directory) {
+        refresh_content();
+    }
+    if (_other_panel.current_directory == _directory) {
+        _other_panel.refresh_content();
+    }
+}
+
+void file_panel::overwrite_content_copy(file_panel &_other_panel, const std::filesystem::path &_from,
+                                        const std::filesystem::path &_to, const std::string &_name, bool _all,
+                                        COPY_BACKEND _backend, job_progress &_job) {
+    std::atomic<bool> overwrite_other(_all);
+    std::mutex prompt_mutex;
+    trace_clock::time_point start = trace_clock::now();
+    if (!exists((_to / _name))) {
+        std::filesystem::create_directory(_to / _name);
+    }
+    size_t index = _from.string().rfind(_name);
+    tree_walker *walker_ptr = nullptr;
+    auto count_copied = [&_job](uint64_t _bytes, uint64_t _written) {
+        _job.add_files(1);
+        _job.add_bytes(_bytes);
+        _job.add_written(_written);
+    };
+    // With verify on, every walker thread hands its finished files to one
+    // verifier and goes on copying while it re-reads them.
+    std::unique_ptr<copy_verifier> verifier;
+    if (_job.is_verifying()) {
+        verifier = std::make_unique<copy_verifier>([&_job]() {
+            _job.add_verified(1);
+        }, [&_job](const std::filesystem::path &_target, const std::string &_reason) {
+            _job.add_mismatch(_target.string() + ": " + _reason);
+        });
+    }
+    // One batching io_uring per walker thread; regular files queue there and
+    // the rest (and everything, when the ring cannot be set up) copy inline.
+    // The ring never checksums what it writes, so verified copies skip it.
+    std::vector<std::unique_ptr<uring_copier>> copiers;
+    if (_backend == COPY_BACKEND::URING && !verifier) {
+        for (size_t i = 0; i < tree_walk_threads(); i++) {
+            copiers.push_back(std::make_unique<uring_copier>(count_copied, [this, &_other_panel](const std::filesystem::filesystem_error &e) {
+                report_filesystem_error(*this, _other_panel, e);
+            }));
+        }
+    }
+    auto copy_regular = [&copiers, &verifier, &_job](size_t _thread, const std::filesystem::directory_entry &_source,
+                                                  const std::filesystem::path &_target,
+                                                  std::filesystem::copy_options _options) {
+        if (!copiers.empty() && copiers[_thread]->is_ready() && _source.is_regular_file()) {
+            copiers[_thread]->add(_source.path(), _target, _options == std::filesystem::copy_options::overwrite_existing);
+            return;
+        }
+        bool check = verifier && _source.is_regular_file();
+        uint32_t checksum = 0;
+        uint64_t written = 0;
+        // Bytes are counted as they are written, so a large file shows progress.
+        if (copy_file_native(_source.path(), _target, _options, &written, _job.get_byte_counter(),
+                             check ? &checksum : nullptr) != COPY_METHOD::NONE) {
+            _job.add_files(1);
+            _job.add_written(written);
+            if (check) {
+                verifier->add(_target, checksum);
+            }
+        }
+    };
+    tree_walker walker([&](size_t thread, const std::filesystem::directory_entry &entry) {
+        if (!_job.checkpoint()) {
+            walker_ptr->cancel();
+            return false;
+        }
+        std::string path_string = entry.path().string();
+        std::filesystem::path copy_part(path_string.substr(index));
+        bool flag_skip = false;
+        std::filesystem::path full_copy_path = _to / copy_part;
+        try {
+            if (!exists(full_copy_path)) {
+                if (entry.is_directory()) {
+                    if (entry.is_symlink()) {
                         std::filesystem::copy_symlink(entry.path(), full_copy_path);
-                    } else if (entry.is_regular_file() || entry.is_character_file() || entry.is_block_file()
-                               || entry.is_socket() || entry.is_fifo()) {
-                        std::filesystem::copy_file(entry.path(), full_copy_path);
+                    } else {
+                        std::filesystem::create_directory(full_copy_path);
                     }
-                } else {
-                    if (!overwrite_other) {
-                        display_content();
-                        _other_panel.display_content();
+                } else if (entry.is_symlink()) {
+                    std::filesystem::copy_symlink(entry.path(), full_copy_path);
+                } else if (entry.is_regular_file() || entry.is_character_file() || entry.is_block_file()
+                           || entry.is_socket() || entry.is_fifo()) {
+                    copy_regular(thread, entry, full_copy_path, std::filesystem::copy_options::none);
+                }
+            } else {
+                REMOVE_TYPE type = REMOVE_TYPE::REMOVE_THIS;
+                if (!overwrite_other.load()) {
+                    // One prompt at a time; "All" or "Stop" from an earlier
+                    // prompt settles the ones queued behind it.
+                    std::lock_guard<std::mutex> lock(prompt_mutex);
+                    if (walker_ptr->is_cancelled()) {
+                        return false;
+                    }
+                    if (!overwrite_other.load()) {
                         std::string message = "Overwrite: " + path_string;
-                        type = create_remove_panel(HEADER_COPY, message, HEIGHT_FUNCTIONAL_PANEL - 2,
-                                                   WEIGHT_FUNCTIONAL_PANEL > message.length()
-                                                   ? WEIGHT_FUNCTIONAL_PANEL : message.length() + 2);
+                        type = ask_remove_panel(*this, _other_panel, HEADER_COPY, message, HEIGHT_FUNCTIONAL_PANEL - 2,
+                                                WEIGHT_FUNCTIONAL_PANEL > message.length()
+                                                ? WEIGHT_FUNCTIONAL_PANEL : message.length() + 2);
                     }
-                    if (type == REMOVE_TYPE::REMOVE_ALL) {
-                        display_content();
-                        _other_panel.display_content();
-                        overwrite_other = true;
-                    } else if (type == REMOVE_TYPE::STOP_REMOVE) {
-                        return;
-                    } else if (type == REMOVE_TYPE::REMOVE_THIS || overwrite_other) {
-                        bool is_correct_types = true;
-                        if ((entry.is_directory() && !entry.is_symlink())) {
-                            if (is_directory(full_copy_path) && !is_symlink(full_copy_path)) {
-                                is_correct_types = true;
-                            } else {
-                                is_correct_types = false;
-                                flag_skip = true;
-                            }
-                        } else if ((entry.is_symlink() && entry.is_directory()) ||
-                                   (entry.is_symlink() && !entry.is_directory())) {
-                            if (!is_symlink(full_copy_path)) {
-                                is_correct_types = false;
-                            }
-                        } else if (!entry.is_symlink()) {
-                            if (is_symlink(full_copy_path)) {
-                                is_correct_types = false;
-                            }
-                        }
-                        if (is_correct_types) {
-                            if ((entry.is_directory() && entry.is_symlink()) || (entry.is_symlink())) {
-                                std::filesystem::remove(full_copy_path);
-                                std::filesystem::copy_symlink(entry.path(), full_copy_path);
-                            } else if (entry.is_regular_file() || entry.is_fifo() || entry.is_character_file()
-                                       || entry.is_block_file() || entry.is_socket()) {
-                                std::filesystem::copy_file(entry.path(), full_copy_path,
-                                                           std::filesystem::copy_options::overwrite_existing);
-                            }
+                }
+                if (type == REMOVE_TYPE::REMOVE_ALL) {
+                    overwrite_other.store(true);
+                } else if (type == REMOVE_TYPE::STOP_REMOVE) {
+                    walker_ptr->cancel();
+                    return false;
+                }
+                if (type == REMOVE_TYPE::REMOVE_THIS || overwrite_other.load()) {
+                    bool is_correct_types = true;
+                    if ((entry.is_directory() && !entry.is_symlink())) {
+                        if (is_directory(full_copy_path) && !is_symlink(full_copy_path)) {
+                            is_correct_types = true;
                         } else {
-                            throw std::filesystem::filesystem_error("Another types", entry.path(), full_copy_path,
-                                                                    std::error_code(21, std::iostream_category()));
+                            is_correct_types = false;
+                            flag_skip = true;
+                        }
+                    } else if ((entry.is_symlink() && entry.is_directory()) ||
+                               (entry.is_symlink() && !entry.is_directory())) {
+                        if (!is_symlink(full_copy_path)) {
+                            is_correct_types = false;
+                        }
+                    } else if (!entry.is_symlink()) {
+                        if (is_symlink(full_copy_path)) {
+                            is_correct_types = false;
                         }
                     }
+                    if (is_correct_types) {
+                        if ((entry.is_directory() && entry.is_symlink()) || (entry.is_symlink())) {
+                            std::filesystem::remove(full_copy_path);
+                            std::filesystem::copy_symlink(entry.path(), full_copy_path);
+                        } else if (entry.is_regular_file() || entry.is_fifo() || entry.is_character_file()
+                                   || entry.is_block_file() || entry.is_socket()) {
+                            copy_regular(thread, entry, full_copy_path,
+                                         std::filesystem::copy_options::overwrite_existing);
+                        }
+                    } else {
+                        throw std::filesystem::filesystem_error("Another types", entry.path(), full_copy_path,
+                                                                std::error_code(21, std::iostream_category()));
+                    }
                 }
-            } catch (std::filesystem::filesystem_error& e) {
-                display_content();
-                _other_panel.display_content();
-                int error_ind = e.code().value();
-                if (error_ind == 13) {
-                    generate_permission_error(e);
-                } else if (error_ind == 21 || error_ind == 22) {
-                    generate_incompatible_error(e);
-                }
-            }
-            if (!flag_skip && entry.is_directory()) {
-                dir_stack.push(entry.path());
             }
+        } catch (std::filesystem::filesystem_error& e) {
+            report_filesystem_error(*this, _other_panel, e);
+        }
+        return !flag_skip && entry.is_directory();
+    }, [this, &_other_panel](const std::filesystem::filesystem_error &e) {
+        report_filesystem_error(*this, _other_panel, e);
+    });
+    walker_ptr = &walker;
+    walker.set_idle([&copiers](size_t thread) {
+        if (!copiers.empty()) {
+            copiers[thread]->flush();
         }
+    });
+    walker.walk(_from);
+    if (verifier) {
+        verifier->finish();
     }
+    copy_stats.record_tree(_job.get_done_files(), _job.get_done_bytes(), elapsed_ns(start, trace_clock::now()));
 }
 
 void file_panel::move_content(file_panel& _other_panel) {
+    scoped_span span(SPAN_KIND::FILE_OP);
     if (content[current_ind].name_content != "/..") {
         std::string path_to_move = _other_panel.current_directory;
-        bool entry_flag = create_redact_other_func_panel(HEADER_MOVE, "Move '" + content[current_ind]
-                                                                 .name_content + "' to::", path_to_move,
+        bool entry_flag = create_redact_other_func_panel(HEADER_MOVE, "Move '" + std::string(content[current_ind]
+                                                                 .name_content) + "' to::", path_to_move,
                                                          HEIGHT_FUNCTIONAL_PANEL, WEIGHT_FUNCTIONAL_PANEL);
         if (entry_flag) {
-            std::filesystem::path move_from(current_directory + "/" + content[current_ind].name_content);
+            std::filesystem::path move_from(current_directory + "/" + std::string(content[current_ind].name_content));
             std::filesystem::path move_to(path_to_move);
             std::filesystem::path move_to_full(move_to / content[current_ind].name_content);
 
@@ -857,8 +1432,8 @@ void file_panel::move_content(file_panel& _other_panel) {
             if (!exists(move_to_full)) {
                 try {
                     std::filesystem::rename(move_from, move_to_full);
-                    _other_panel.read_current_dir();
-                    this->read_current_dir();
+                    _other_panel.refresh_content();
+                    this->refresh_content();
                     if (current_ind >= content.size()) {
                         current_ind = content.size() - 1;
                     }
@@ -898,14 +1473,7 @@ void file_panel::move_content(file_panel& _other_panel) {
                                            ? WEIGHT_FUNCTIONAL_PANEL : message.length() + 2);
                         return;
                     }
-                    overwrite_content_move(_other_panel, move_from, move_to);
-                    if (std::filesystem::exists(move_from) && std::filesystem::is_empty(move_from)) {
-                        std::filesystem::remove(move_from);
-                    }
-                    this->read_current_dir();
-                    if (current_ind >= content.size()) {
-                        current_ind = content.size() - 1;
-                    }
+                    start_move_tree(_other_panel, move_from, move_to);
                 } else {
                     std::string message = "Overwrite: " + move_to_full.string();
                     REMOVE_TYPE type = create_remove_panel(HEADER_MOVE, message, HEIGHT_FUNCTIONAL_PANEL - 2,
@@ -932,12 +1500,12 @@ void file_panel::move_content(file_panel& _other_panel) {
                             }
                             std::filesystem::remove(move_to_full);
                             std::filesystem::rename(move_from, move_to_full);
-                            read_current_dir();
+                            refresh_content();
                             if (current_ind >= content.size()) {
                                 current_ind = content.size() - 1;
                             }
                             if (_other_panel.current_directory == path_to_move) {
-                                _other_panel.read_current_dir();
+                                _other_panel.refresh_content();
                             }
                         } catch (std::filesystem::filesystem_error& e) {
                             display_content();
@@ -963,10 +1531,11 @@ const std::string &file_panel::get_current_directory() const {
 }
 
 void file_panel::edit_permissions(file_panel &_other_panel) {
+    scoped_span span(SPAN_KIND::FILE_OP);
     if (content[current_ind].name_content == "..") {
         return;
     }
-    std::string path = current_directory + "/" + content[current_ind].name_content;
+    std::string path = current_directory + "/" + std::string(content[current_ind].name_content);
     std::filesystem::path dir_path(path);
     std::filesystem::perms p = std::filesystem::status(dir_path).permissions();
     char_permissions perms;
@@ -986,7 +1555,7 @@ void file_panel::edit_permissions(file_panel &_other_panel) {
 
     perms.recursive = '-';
 
-    bool entry_flag = change_permissions_panel(EDIT_PERMISSIONS, content[current_ind].name_content,
+    bool entry_flag = change_permissions_panel(EDIT_PERMISSIONS, std::string(content[current_ind].name_content),
                                                HEIGHT_FUNCTIONAL_PANEL + 1,
                                                WEIGHT_FUNCTIONAL_PANEL,
                                                perms);
@@ -994,12 +1563,11 @@ void file_panel::edit_permissions(file_panel &_other_panel) {
     if (entry_flag) {
         std::filesystem::perms new_perms = std::filesystem::perms::none;
         fill_permissions(perms, new_perms);
+        if (perms.recursive == 'X' && std::filesystem::is_directory(path)) {
+            start_chmod_tree(_other_panel, dir_path, new_perms);
+            return;
+        }
         try {
-            if (perms.recursive == 'X' && std::filesystem::is_directory(path)) {
-                for (auto &&entry: std::filesystem::recursive_directory_iterator(path)) {
-                    std::filesystem::permissions(entry.path(), new_perms, std::filesystem::perm_options::replace);
-                }
-            }
             std::filesystem::permissions(path, new_perms, std::filesystem::perm_options::replace);
         } catch (std::filesystem::filesystem_error &e) {
             int error_ind = e.code().value();
@@ -1012,11 +1580,33 @@ void file_panel::edit_permissions(file_panel &_other_panel) {
     }
 }
 
+void file_panel::start_chmod_tree(file_panel &_other_panel, const std::filesystem::path &_path,
+                                  std::filesystem::perms _perms) {
+    std::shared_ptr<job_progress> job = job_board.begin(JOB_KIND::CHMOD, _path.filename().string(), _path, {_path});
+    file_jobs.submit(job, [this, &_other_panel, _path, _perms, job]() {
+        try {
+            for (auto &&entry: std::filesystem::recursive_directory_iterator(_path)) {
+                if (!job->checkpoint()) {
+                    return;
+                }
+                std::filesystem::permissions(entry.path(), _perms, std::filesystem::perm_options::replace);
+                job->add_files(1);
+            }
+            std::filesystem::permissions(_path, _perms, std::filesystem::perm_options::replace);
+        } catch (std::filesystem::filesystem_error &e) {
+            report_filesystem_error(*this, _other_panel, e);
+        }
+    }, [this, &_other_panel, _path]() {
+        refresh_if_showing(_other_panel, _path.parent_path().string());
+    });
+}
+
 void file_panel::delete_content(file_panel &_other_panel) {
+    scoped_span span(SPAN_KIND::FILE_OP);
     if (content[current_ind].name_content == "..") {
         return;
     }
-    std::string current_path = current_directory + "/" + content[current_ind].name_content;
+    std::string current_path = current_directory + "/" + std::string(content[current_ind].name_content);
     std::filesystem::path p(current_path);
     REMOVE_TYPE type;
     bool flag_permission_read = true;
@@ -1032,31 +1622,19 @@ void file_panel::delete_content(file_panel &_other_panel) {
         }
     }
     if ((is_directory(p) && !is_symlink(p)) && !flag_permission_read) {
-        sequential_removing(p, _other_panel, false);
-        if (!std::filesystem::exists(_other_panel.current_directory + "/" + _other_panel
-                .content[_other_panel.current_ind].name_content)) {
-            if (_other_panel.current_directory.length() >= current_path.length()) {
-                std::string substr = _other_panel.current_directory.substr(0, current_path.length());
-                if (substr == current_path) {
-                    //_other_panel.current_directory = current_directory;
-                    std::filesystem::path new_path(_other_panel.current_directory);
-                    while(!exists(new_path)) {
-                        new_path = new_path.parent_path();
-                    }
-                    _other_panel.current_directory = new_path.string();
-                }
+        std::string name(content[current_ind].name_content);
+        std::shared_ptr<job_progress> job = job_board.begin(JOB_KIND::DELETE, name, p, {p});
+        file_jobs.submit(job, [this, &_other_panel, p, name, job]() {
+            try {
+                sequential_removing(p, _other_panel, name, false, *job);
+            } catch (std::filesystem::filesystem_error &e) {
+                report_filesystem_error(*this, _other_panel, e);
             }
-        }
-        read_current_dir();
-        _other_panel.read_current_dir();
-        if (current_ind >= content.size()) {
-            current_ind = content.size() - 1;
-        }
-        if (_other_panel.current_ind >= _other_panel.content.size()) {
-            _other_panel.current_ind = _other_panel.content.size() - 1;
-        }
+        }, [this, &_other_panel, current_path]() {
+            finish_removing(_other_panel, current_path);
+        });
     } else {
-        type = create_remove_panel(HEADER_DELETE, "Delete: " + content[current_ind].name_content,
+        type = create_remove_panel(HEADER_DELETE, "Delete: " + std::string(content[current_ind].name_content),
                                    HEIGHT_FUNCTIONAL_PANEL - 2,
                                    WEIGHT_FUNCTIONAL_PANEL);
         if (type == REMOVE_TYPE::REMOVE_ALL || type == REMOVE_TYPE::REMOVE_THIS) {
@@ -1069,8 +1647,8 @@ void file_panel::delete_content(file_panel &_other_panel) {
                 if (is_dir) {
                     _other_panel.current_directory = current_directory;
                 }
-                read_current_dir();
-                _other_panel.read_current_dir();
+                refresh_content();
+                _other_panel.refresh_content();
                 if (current_ind >= content.size()) {
                     current_ind = content.size() - 1;
                 }
@@ -1087,24 +1665,44 @@ void file_panel::delete_content(file_panel &_other_panel) {
     }
 }
 
-void file_panel::sequential_removing(std::filesystem::path &_p, file_panel &_other_panel, bool _all) {
+void file_panel::finish_removing(file_panel &_other_panel, const std::string &_removed_path) {
+    if (!_other_panel.content.empty()
+        && !std::filesystem::exists(_other_panel.current_directory + "/" + std::string(_other_panel
+                .content[_other_panel.current_ind].name_content))) {
+        if (_other_panel.current_directory.length() >= _removed_path.length()) {
+            std::string substr = _other_panel.current_directory.substr(0, _removed_path.length());
+            if (substr == _removed_path) {
+                //_other_panel.current_directory = current_directory;
+                std::filesystem::path new_path(_other_panel.current_directory);
+                while(!exists(new_path)) {
+                    new_path = new_path.parent_path();
+                }
+                _other_panel.current_directory = new_path.string();
+            }
+        }
+    }
+    refresh_content();
+    _other_panel.refresh_content();
+    if (current_ind >= content.size()) {
+        current_ind = content.size() - 1;
+    }
+    if (_other_panel.current_ind >= _other_panel.content.size()) {
+        _other_panel.current_ind = _other_panel.content.size() - 1;
+    }
+}
+
+void file_panel::sequential_removing(const std::filesystem::path &_p, file_panel &_other_panel,
+                                     const std::string &_name, bool _all, job_progress &_job) {
     try {
         if (is_symlink(_p)) {
             std::filesystem::remove(_p);
-            read_current_dir();
-            if (_other_panel.current_directory == current_directory) {
-                _other_panel.read_current_dir();
-            }
             return;
         }
     } catch (std::filesystem::filesystem_error &e) {
-        int error_ind = e.code().value();
-        if (error_ind == 13) {
-            generate_permission_error(e);
-        }
+        report_filesystem_error(*this, _other_panel, e);
     }
-    REMOVE_TYPE type;
-    size_t index = _p.string().rfind(content[current_ind].name_content);
+    REMOVE_TYPE type = REMOVE_TYPE::REMOVE_THIS;
+    size_t index = _p.string().rfind(_name);
     std::stack<std::filesystem::path> dir_stack;
     bool flag_delete_other = _all;
     dir_stack.push(_p);
@@ -1114,11 +1712,14 @@ void file_panel::sequential_removing(std::filesystem::path &_p, file_panel &_oth
         for (const auto &entry: std::filesystem::directory_iterator(current_path,
                                                                     std::filesystem::directory_options::skip_permission_denied)) {
             //bool delete_empty_subdir = false;
+            if (!_job.checkpoint()) {
+                return;
+            }
             if (!flag_delete_other) {
                 std::string message = "Delete: " + entry.path().string().substr(index);
-                type = create_remove_panel(HEADER_DELETE, message, HEIGHT_FUNCTIONAL_PANEL - 2,
-                                           WEIGHT_FUNCTIONAL_PANEL - 1 > message.length() ? WEIGHT_FUNCTIONAL_PANEL :
-                                           message.length() + 2);
+                type = ask_remove_panel(*this, _other_panel, HEADER_DELETE, message, HEIGHT_FUNCTIONAL_PANEL - 2,
+                                        WEIGHT_FUNCTIONAL_PANEL - 1 > message.length() ? WEIGHT_FUNCTIONAL_PANEL :
+                                        message.length() + 2);
             }
             try {
                 if (type == REMOVE_TYPE::REMOVE_ALL) {
@@ -1126,18 +1727,15 @@ void file_panel::sequential_removing(std::filesystem::path &_p, file_panel &_oth
                 }
                 if (type == REMOVE_TYPE::REMOVE_THIS || flag_delete_other) {
                     if (entry.is_directory()) {
-                        std::filesystem::remove_all(entry.path());
-                    } else std::filesystem::remove(entry.path());
+                        _job.add_files(std::filesystem::remove_all(entry.path()));
+                    } else if (std::filesystem::remove(entry.path())) {
+                        _job.add_files(1);
+                    }
                 }
 
             } catch (std::filesystem::filesystem_error &e) {
-                int error_ind = e.code().value();
-                if (error_ind == 13) {
-                    generate_permission_error(e);
-                }
+                report_filesystem_error(*this, _other_panel, e);
             }
-            display_content();
-            _other_panel.display_content();
             if (type == REMOVE_TYPE::STOP_REMOVE) {
                 return;
             }
@@ -1150,12 +1748,10 @@ void file_panel::sequential_removing(std::filesystem::path &_p, file_panel &_oth
         if (flag_delete_other) {
             std::filesystem::remove(_p);
         } else {
-            display_content();
-            _other_panel.display_content();
             std::string message = "Delete: " + _p.string().substr(index);
-            type = create_remove_panel(HEADER_DELETE, message, HEIGHT_FUNCTIONAL_PANEL - 2,
-                                       WEIGHT_FUNCTIONAL_PANEL - 1 > message.length()
-                                       ? WEIGHT_FUNCTIONAL_PANEL : message.length() + 2);
+            type = ask_remove_panel(*this, _other_panel, HEADER_DELETE, message, HEIGHT_FUNCTIONAL_PANEL - 2,
+                                    WEIGHT_FUNCTIONAL_PANEL - 1 > message.length()
+                                    ? WEIGHT_FUNCTIONAL_PANEL : message.length() + 2);
             if (type == REMOVE_TYPE::REMOVE_ALL || type == REMOVE_TYPE::REMOVE_THIS) {
                 std::filesystem::remove(_p);
             }
@@ -1163,19 +1759,50 @@ void file_panel::sequential_removing(std::filesystem::path &_p, file_panel &_oth
     }
 }
 
-void file_panel::overwrite_content_move(file_panel &_other_panel, std::filesystem::path &_from, std::filesystem::path &_to) {
+void file_panel::start_move_tree(file_panel &_other_panel, const std::filesystem::path &_from,
+                                 const std::filesystem::path &_to) {
+    std::string name(content[current_ind].name_content);
+    size_t index = _from.string().rfind(name);
+    // The move renames whole subtrees that are missing on the other side and
+    // only walks into directories present on both, so the scan does the same.
+    std::shared_ptr<job_progress> job = job_board.begin(JOB_KIND::MOVE, name, _from, {_from, _to},
+                                                        [_to, index](const std::filesystem::directory_entry &_entry) {
+        std::filesystem::path target = _to / _entry.path().string().substr(index);
+        return is_directory(target) && !is_symlink(target);
+    });
+    file_jobs.submit(job, [this, &_other_panel, _from, _to, name, job]() {
+        try {
+            overwrite_content_move(_other_panel, _from, _to, name, *job);
+            if (std::filesystem::exists(_from) && std::filesystem::is_empty(_from)) {
+                std::filesystem::remove(_from);
+            }
+        } catch (std::filesystem::filesystem_error &e) {
+            report_filesystem_error(*this, _other_panel, e);
+        }
+    }, [this, &_other_panel]() {
+        refresh_content();
+        _other_panel.refresh_content();
+        if (current_ind >= content.size()) {
+            current_ind = content.size() - 1;
+        }
+    });
+}
+
+void file_panel::overwrite_content_move(file_panel &_other_panel, const std::filesystem::path &_from,
+                                        const std::filesystem::path &_to, const std::string &_name,
+                                        job_progress &_job) {
     bool overwrite_other = false;
     REMOVE_TYPE type;
-    std::string message = "Overwrite: " + _to.string() + "/" + content[current_ind].name_content;
-    type = create_remove_panel(HEADER_MOVE, message, HEIGHT_FUNCTIONAL_PANEL - 2,
-                               WEIGHT_FUNCTIONAL_PANEL > message.length()
-                               ? WEIGHT_FUNCTIONAL_PANEL : message.length() + 2);
+    std::string message = "Overwrite: " + _to.string() + "/" + _name;
+    type = ask_remove_panel(*this, _other_panel, HEADER_MOVE, message, HEIGHT_FUNCTIONAL_PANEL - 2,
+                            WEIGHT_FUNCTIONAL_PANEL > message.length()
+                            ? WEIGHT_FUNCTIONAL_PANEL : message.length() + 2);
     if (type == REMOVE_TYPE::REMOVE_ALL) {
         overwrite_other = true;
     } else if (type == REMOVE_TYPE::STOP_REMOVE || type == REMOVE_TYPE::SKIP) {
         return;
     }
-    size_t index = _from.string().rfind(content[current_ind].name_content);
+    size_t index = _from.string().rfind(_name);
     std::stack<std::filesystem::path> dir_stack;
     dir_stack.push(_from);
     while(!dir_stack.empty()) {
@@ -1183,6 +1810,9 @@ void file_panel::overwrite_content_move(file_panel &_other_panel, std::filesyste
         bool flag_is_empty_after_move = false;
         dir_stack.pop();
         for (const auto& entry : std::filesystem::directory_iterator(current_path, std::filesystem::directory_options::skip_permission_denied)) {
+            if (!_job.checkpoint()) {
+                return;
+            }
             bool flag_skip = false;
             std::string path_string = entry.path().string();
             std::filesystem::path copy_part(path_string.substr(index));
@@ -1192,29 +1822,19 @@ void file_panel::overwrite_content_move(file_panel &_other_panel, std::filesyste
                 flag_skip = true;
                 try {
                     std::filesystem::rename(entry.path(), full_copy_to);
+                    _job.add_files(1);
                     flag_is_empty_after_move = true;
                 } catch (std::filesystem::filesystem_error &e) {
-                    display_content();
-                    _other_panel.display_content();
-                    int error_ind = e.code().value();
-                    if (error_ind == 13) {
-                        generate_permission_error(e);
-                    } else if (error_ind == 21 || error_ind == 22) {
-                        generate_incompatible_error(e);
-                    }
+                    report_filesystem_error(*this, _other_panel, e);
                 }
             } else {
                 if (!overwrite_other) {
-                    display_content();
-                    _other_panel.display_content();
                     message = "Overwrite: " + path_string;
-                    type = create_remove_panel(HEADER_MOVE, message, HEIGHT_FUNCTIONAL_PANEL - 2,
-                                               WEIGHT_FUNCTIONAL_PANEL > message.length()
-                                               ? WEIGHT_FUNCTIONAL_PANEL : message.length() + 2);
+                    type = ask_remove_panel(*this, _other_panel, HEADER_MOVE, message, HEIGHT_FUNCTIONAL_PANEL - 2,
+                                            WEIGHT_FUNCTIONAL_PANEL > message.length()
+                                            ? WEIGHT_FUNCTIONAL_PANEL : message.length() + 2);
                 }
                 if (type == REMOVE_TYPE::REMOVE_ALL) {
-                    display_content();
-                    _other_panel.display_content();
                     overwrite_other = true;
                 }
                 if (type == REMOVE_TYPE::STOP_REMOVE) {
@@ -1245,20 +1865,14 @@ void file_panel::overwrite_content_move(file_panel &_other_panel, std::filesyste
                              entry.is_symlink())) {
                             std::filesystem::remove(full_copy_to);
                             std::filesystem::rename(entry.path(), full_copy_to);
+                            _job.add_files(1);
                             flag_is_empty_after_move = true;
                         } else if (!is_correct_types) {
                             throw std::filesystem::filesystem_error("Another types", entry.path(), full_copy_to,
                                                                     std::error_code(21, std::iostream_category()));
                         }
                     } catch (std::filesystem::filesystem_error &e) {
-                        display_content();
-                        _other_panel.display_content();
-                        int error_ind = e.code().value();
-                        if (error_ind == 13) {
-                            generate_permission_error(e);
-                        } else if (error_ind == 21 || error_ind == 22) {
-                            generate_incompatible_error(e);
-                        }
+                        report_filesystem_error(*this, _other_panel, e);
                     }
                 }
             }
@@ -1272,6 +1886,32 @@ void file_panel::overwrite_content_move(file_panel &_other_panel, std::filesyste
     }
 }
 
+REMOVE_TYPE ask_remove_panel(file_panel &_first, file_panel &_second, const std::string &_header,
+                             const std::string &_message, int _height, int _weight) {
+    return background.ask<REMOVE_TYPE>([&]() {
+        _first.display_content();
+        _second.display_content();
+        return create_remove_panel(_header, _message, _height, _weight);
+    }, REMOVE_TYPE::STOP_REMOVE);
+}
+
+void report_filesystem_error(file_panel &_first, file_panel &_second, const std::filesystem::filesystem_error &e) {
+    int error_ind = e.code().value();
+    if (error_ind != 13 && error_ind != 20 && error_ind != 21 && error_ind != 22) {
+        return;
+    }
+    std::filesystem::filesystem_error error = e;
+    background.ask([&]() {
+        _first.display_content();
+        _second.display_content();
+        if (error_ind == 13) {
+            generate_permission_error(error);
+        } else {
+            generate_incompatible_error(error);
+        }
+    });
+}
+
 void generate_permission_error(std::filesystem::filesystem_error &e) {
     std::string message = e.path1().string();
     if (message.empty()) {
@@ -1292,15 +1932,288 @@ void generate_incompatible_error(std::filesystem::filesystem_error &e) {
 }
 
 info::info(std::string_view _name_content,
-           std::string_view _last_redact_content,
-           ssize_t _current_ind,
+           int64_t _modify_time,
+           ssize_t _size_content,
            CONTENT_TYPE _content_type,
            COLOR_INDEX _color_index) {
     this->content_type = _content_type;
     this->name_content = _name_content;
-    this->last_redact_content = _last_redact_content;
-    this->size_content = _current_ind;
+    this->modify_time = _modify_time;
+    this->size_content = _size_content;
     this->color_index = _color_index;
+    this->id = 0;
+}
+
+name_arena::name_arena() {
+    this->block_used = 0;
+    this->block_capacity = 0;
+    this->total_bytes = 0;
+}
+
+std::string_view name_arena::store(std::string_view _name) {
+    size_t len = _name.size() + 1;
+    if (block_used + len > block_capacity) {
+        block_capacity = len > NAME_ARENA_BLOCK_SIZE ? len : NAME_ARENA_BLOCK_SIZE;
+        blocks.emplace_back(new char[block_capacity]);
+        block_used = 0;
+        total_bytes += block_capacity;
+    }
+    char *dest = blocks.back().get() + block_used;
+    memcpy(dest, _name.data(), _name.size());
+    dest[_name.size()] = '\0';
+    block_used += len;
+    return {dest, _name.size()};
+}
+
+size_t name_arena::bytes() const {
+    return total_bytes;
+}
+
+listing::listing() : arena(std::make_shared<name_arena>()), permutations(SORT_SLOT_COUNT) {
+    this->live_bytes = 0;
+    this->next_id = 0;
+    this->current_slot = SORT_SLOT_NONE;
+    touch();
+}
+
+void listing::touch() {
+    stamp = ++listing_stamp_counter;
+}
+
+uint64_t listing::get_stamp() const {
+    return stamp;
+}
+
+void listing::adopt_arena(std::shared_ptr<name_arena> _arena) {
+    arena = std::move(_arena);
+}
+
+std::string_view listing::intern(std::string_view _name) {
+    return arena->store(_name);
+}
+
+void listing::push_back(const info &_entry) {
+    invalidate_permutations();
+    touch();
+    entries.push_back(_entry);
+    entries.back().id = next_id++;
+    live_bytes += _entry.name_content.size() + 1;
+}
+
+listing::iterator listing::insert(const_iterator _pos, const info &_entry) {
+    invalidate_permutations();
+    touch();
+    live_bytes += _entry.name_content.size() + 1;
+    auto it = entries.insert(_pos, _entry);
+    it->id = next_id++;
+    return it;
+}
+
+listing::iterator listing::erase(const_iterator _pos) {
+    invalidate_permutations();
+    touch();
+    live_bytes -= _pos->name_content.size() + 1;
+    return entries.erase(_pos);
+}
+
+listing::iterator listing::erase(const_iterator _first, const_iterator _last) {
+    if (_first == _last) {
+        return entries.begin() + (_first - entries.cbegin());
+    }
+    invalidate_permutations();
+    touch();
+    for (auto it = _first; it != _last; ++it) {
+        live_bytes -= it->name_content.size() + 1;
+    }
+    return entries.erase(_first, _last);
+}
+
+void listing::reserve(size_t _count) {
+    entries.reserve(_count);
+}
+
+void listing::clear() {
+    std::vector<info>().swap(entries);
+    arena = std::make_shared<name_arena>();
+    live_bytes = 0;
+    next_id = 0;
+    invalidate_permutations();
+    touch();
+}
+
+void listing::compact() {
+    if (arena->bytes() < 2 * live_bytes + NAME_ARENA_COMPACT_SLACK) {
+        return;
+    }
+    auto fresh = std::make_shared<name_arena>();
+    for (auto &&entry: entries) {
+        entry.name_content = fresh->store(entry.name_content);
+    }
+    arena = std::move(fresh);
+    touch();
+}
+
+void listing::apply_permutation(const std::vector<uint32_t> &_order) {
+    std::vector<info> ordered;
+    ordered.reserve(entries.size());
+    for (auto &&ind: _order) {
+        ordered.push_back(entries[ind]);
+    }
+    entries.swap(ordered);
+    current_slot = SORT_SLOT_NONE;
+    touch();
+}
+
+bool listing::restore_permutation(size_t _slot) {
+    if (_slot == current_slot) {
+        return true;
+    }
+    const std::vector<uint32_t> &ids = permutations[_slot];
+    if (ids.empty() || ids.size() != entries.size()) {
+        return false;
+    }
+    std::vector<uint32_t> position(next_id);
+    for (size_t i = 0; i < entries.size(); i++) {
+        position[entries[i].id] = static_cast<uint32_t>(i);
+    }
+    std::vector<uint32_t> order;
+    order.reserve(ids.size());
+    for (auto &&id: ids) {
+        order.push_back(position[id]);
+    }
+    apply_permutation(order);
+    current_slot = _slot;
+    return true;
+}
+
+void listing::remember_permutation(size_t _slot) {
+    std::vector<uint32_t> &ids = permutations[_slot];
+    ids.resize(entries.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+        ids[i] = entries[i].id;
+    }
+    current_slot = _slot;
+}
+
+void listing::invalidate_permutations() {
+    current_slot = SORT_SLOT_NONE;
+    for (auto &&ids: permutations) {
+        if (!ids.empty()) {
+            std::vector<uint32_t>().swap(ids);
+        }
+    }
+}
+
+size_t listing::position_of(uint32_t _id) const {
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].id == _id) {
+            return i;
+        }
+    }
+    return std::string::npos;
+}
+
+size_t listing::size() const {
+    return entries.size();
+}
+
+bool listing::empty() const {
+    return entries.empty();
+}
+
+size_t listing::bytes() const {
+    size_t total = entries.capacity() * sizeof(info) + arena->bytes();
+    for (auto &&ids: permutations) {
+        total += ids.capacity() * sizeof(uint32_t);
+    }
+    return total;
+}
+
+info &listing::operator[](size_t _ind) {
+    return entries[_ind];
+}
+
+const info &listing::operator[](size_t _ind) const {
+    return entries[_ind];
+}
+
+listing::iterator listing::begin() {
+    return entries.begin();
+}
+
+listing::iterator listing::end() {
+    return entries.end();
+}
+
+listing::const_iterator listing::begin() const {
+    return entries.begin();
+}
+
+listing::const_iterator listing::end() const {
+    return entries.end();
+}
+
+row_text_cache::row_text_cache() {
+    this->generation = 1;
+}
+
+// Rows are kept per screen line rather than per entry, so the cache never
+// grows past the panel height however large the directory is; scrolling
+// re-formats the lines whose entry changed.
+const row_text &row_text_cache::get(size_t _slot, const info &_entry, size_t _width) {
+    if (_slot >= rows.size()) {
+        rows.resize(_slot + 1, row_text{0, {}, {}, 0, 0, 0});
+    }
+    row_text &row = rows[_slot];
+    if (row.generation == generation && row.id == _entry.id && row.width == _width) {
+        return row;
+    }
+    row.id = _entry.id;
+    row.name.clear();
+    row.name.reserve(_entry.name_content.size() + 1);
+    row.name.append(_entry.name_content);
+    convert_to_output(row.name, _entry.content_type);
+    size_t len = row.name.length();
+    if (_width < len) {
+        size_t head = _width / 2 - 1;
+        row.name.replace(head, len - _width / 2 - head, 1, '~');
+    }
+    row.size_len = 0;
+    row.size[0] = '\0';
+    if (_entry.size_content >= 0) {
+        row.size_len = snprintf(row.size, sizeof(row.size), "%zd", _entry.size_content);
+    }
+    row.width = _width;
+    row.generation = generation;
+    return row;
+}
+
+void row_text_cache::invalidate(uint32_t _id) {
+    for (auto &&row: rows) {
+        if (row.id == _id) {
+            row.generation = 0;
+        }
+    }
+}
+
+void row_text_cache::clear() {
+    generation++;
+}
+
+void flush_frame() {
+    update_panels();
+    doupdate();
+}
+
+void flush_overlay(WINDOW *_win) {
+    update_panels();
+    wnoutrefresh(_win);
+    doupdate();
+}
+
+void close_overlay(WINDOW *_win) {
+    delwin(_win);
+    overlay_epoch++;
 }
 
 WINDOW *create_functional_panel(const std::string &_header, int height, int weight) {
@@ -1316,7 +2229,8 @@ WINDOW *create_functional_panel(const std::string &_header, int height, int weig
     wattroff(win, COLOR_PAIR(5));
 
     wbkgd(win, COLOR_PAIR(4));
-    wrefresh(win);
+    update_panels();
+    wnoutrefresh(win);
 
     curs_set(1);
     return win;
@@ -1353,8 +2267,7 @@ bool symlink_hardlink_func_panel(const std::string &_header,
     wattroff(subwin, A_BOLD);
     wattroff(subwin, COLOR_PAIR(5));
 
-    wrefresh(subwin);
-    wrefresh(win);
+    wnoutrefresh(subwin);
     pos_form_cursor(my_form);
     wrefresh(win);
 
@@ -1366,7 +2279,7 @@ bool symlink_hardlink_func_panel(const std::string &_header,
 
     free_form(my_form);
     delwin(subwin);
-    delwin(win);
+    close_overlay(win);
     curs_set(0);
 
     return entry_flag;
@@ -1382,19 +2295,17 @@ void create_error_panel(const std::string &_header, const std::string &_message,
     wattron(win, A_BOLD);
     mvwprintw(win, 0, (_weight - static_cast<int>(_header.length())) / 2, "%s", _header.c_str());
 
-    wrefresh(win);
-
     mvwprintw(win, _height / 2 - 1,
               (_weight - static_cast<int>(_message.length())) / 2,
               "%s", _message.c_str());
     mvwprintw(win, _height - 1,
               (_weight - static_cast<int>(strlen(PRESS_ANY_BUTTON))) / 2,
               "%s", PRESS_ANY_BUTTON);
-    wrefresh(win);
-    getch();
+    flush_overlay(win);
+    wait_key();
     wattroff(win, A_BOLD);
     wattroff(win, COLOR_PAIR(9));
-    delwin(win);
+    close_overlay(win);
 }
 
 bool navigation_symlink_create_panel(WINDOW *_win, FORM *_form, FIELD **_fields, std::string &_namelink,
@@ -1418,7 +2329,7 @@ bool navigation_symlink_create_panel(WINDOW *_win, FORM *_form, FIELD **_fields,
     wrefresh(_win);
 
     while (true) {
-        switch (ch = getch()) {
+        switch (ch = wait_key()) {
             case '\t' : {
                 form_driver(_form, REQ_NEXT_FIELD);
                 index_field = field_index(current_field(_form));
@@ -1551,6 +2462,7 @@ void init_colors() {
     init_pair(BLUE_COLOR, COLOR_BLUE, COLOR_BLACK);
     init_pair(MAGENTA_COLOR, COLOR_MAGENTA, COLOR_BLACK);
     init_pair(RED_COLOR, COLOR_RED, COLOR_BLACK);
+    init_pair(CYAN_COLOR, COLOR_CYAN, COLOR_BLACK);
 }
 
 void move_cursor_left_from_input_field(size_t *_current_index, int *_current_offset_field) {
@@ -1598,8 +2510,7 @@ bool create_redact_other_func_panel(const std::string &_header,
     wattroff(subwin, A_BOLD);
     wattroff(subwin, COLOR_PAIR(5));
 
-    wrefresh(subwin);
-    wrefresh(win);
+    wnoutrefresh(subwin);
     pos_form_cursor(my_form);
     wrefresh(win);
 
@@ -1611,7 +2522,7 @@ bool create_redact_other_func_panel(const std::string &_header,
 
     free_form(my_form);
     delwin(subwin);
-    delwin(win);
+    close_overlay(win);
     curs_set(0);
     return entry_flag;
 }
@@ -1650,8 +2561,7 @@ REMOVE_TYPE create_remove_panel(const std::string &_header, const std::string &d
     wattroff(win, COLOR_PAIR(5));
     wattroff(win, COLOR_PAIR(5));
 
-    wrefresh(subwin);
-    wrefresh(win);
+    wnoutrefresh(subwin);
     pos_form_cursor(my_form);
     wrefresh(win);
 
@@ -1663,14 +2573,14 @@ REMOVE_TYPE create_remove_panel(const std::string &_header, const std::string &d
 
     free_form(my_form);
     delwin(subwin);
-    delwin(win);
+    close_overlay(win);
     return flag;
 }
 
 REMOVE_TYPE navigation_remove(WINDOW *_win, FORM *_form, FIELD **_fields) {
     int current_ind = -1;
     while (true) {
-        switch (getch()) {
+        switch (wait_key()) {
             case '\t' : {
                 current_ind = field_index(current_field(_form));
                 if (current_ind == 0) {
@@ -1760,8 +2670,7 @@ bool change_permissions_panel(const std::string &_header,
     set_field_buffer(fields[4], 0, OK_BUTTON);
     set_field_buffer(fields[5], 0, NO_BUTTON);
 
-    wrefresh(subwin);
-    wrefresh(win);
+    wnoutrefresh(subwin);
     pos_form_cursor(my_form);
     wrefresh(win);
 
@@ -1773,7 +2682,7 @@ bool change_permissions_panel(const std::string &_header,
 
     free_form(my_form);
     delwin(subwin);
-    delwin(win);
+    close_overlay(win);
     return entry_flag;
 }
 
@@ -1808,50 +2717,59 @@ void find_utility(file_panel& first, file_panel& second, const std::string& _cur
         std::filesystem::perms find_perms = std::filesystem::perms::none;
         fill_permissions(perms_str, find_perms);
         find_perms == std::filesystem::perms::none ? flag_perms = false : flag_perms = true;
-        std::vector<std::string> results;
-        bool is_good_query = find_collect_results(_current_dir, _query, results,
-                                                  flag_reg, flag_dir, flag_lnk, flag_perms,
-                                                  find_perms);
-        try {
-            if (is_good_query) {
-                first.display_content();
-                second.display_content();
-                std::string return_result;
-                create_find_content_panel(results, return_result);
-                std::filesystem::path p(return_result);
-                if (std::filesystem::exists(p)) {
-                    file_panel *current_panel;
-                    if (first.is_active_panel()) {
-                        current_panel = &first;
-                    } else {
-                        current_panel = &second;
-                    }
-                    std::string buffer = p.filename().string();
-                    p = p.parent_path();
-                    current_panel->set_current_directory(p.string());
-                    current_panel->read_current_dir();
-                    const auto &vec = current_panel->get_content();
-                    size_t ind = 0;
-                    for (auto &&it: vec) {
-                        if (it.name_content == buffer) {
-                            current_panel->set_current_ind(ind);
-                            current_panel->set_start_ind(static_cast<int>(ind / (LINES - 4)) * (LINES - 4));
-                            break;
-                        }
-                        ++ind;
-                    }
-                }
+        std::string current_dir(_current_dir);
+        background.submit([&first, &second, current_dir, _query, flag_reg, flag_dir, flag_lnk,
+                           flag_perms, find_perms]() mutable {
+            trace_clock::time_point start = trace_clock::now();
+            std::vector<std::string> results;
+            bool is_good_query;
+            try {
+                is_good_query = find_collect_results(current_dir, _query, results,
+                                                     flag_reg, flag_dir, flag_lnk, flag_perms,
+                                                     find_perms);
+            } catch (std::filesystem::filesystem_error &e) {
+                is_good_query = !results.empty();
             }
-        } catch (std::filesystem::filesystem_error& e) {
-            first.display_content();
-            second.display_content();
-            generate_permission_error(e);
-        }
-        if (!is_good_query) {
+            uint64_t duration = elapsed_ns(start, trace_clock::now());
+            background.post([&first, &second, results = std::move(results), is_good_query, start, duration]() mutable {
+                ui_tracer.record(SPAN_KIND::FIND, start, duration);
+                show_find_results(first, second, results, is_good_query);
+            });
+        });
+    }
+}
+
+void show_find_results(file_panel& first, file_panel& second, std::vector<std::string>& results, bool is_good_query) {
+    try {
+        if (is_good_query) {
             first.display_content();
             second.display_content();
-            create_error_panel(" Find empty ", "No results were found for your request.", 8, 45);
+            std::string return_result;
+            create_find_content_panel(results, return_result);
+            std::filesystem::path p(return_result);
+            if (std::filesystem::exists(p)) {
+                file_panel *current_panel;
+                if (first.is_active_panel()) {
+                    current_panel = &first;
+                } else {
+                    current_panel = &second;
+                }
+                std::string buffer = p.filename().string();
+                p = p.parent_path();
+                current_panel->set_current_directory(p.string());
+                current_panel->read_current_dir();
+                current_panel->select_entry_or_clamp(buffer);
+            }
         }
+    } catch (std::filesystem::filesystem_error& e) {
+        first.display_content();
+        second.display_content();
+        generate_permission_error(e);
+    }
+    if (!is_good_query) {
+        first.display_content();
+        second.display_content();
+        create_error_panel(" Find empty ", "No results were found for your request.", 8, 45);
     }
 }
 
@@ -1871,8 +2789,9 @@ void create_find_content_panel(std::vector<std::string>& _content, std::string&
     size_t start = 0;
     find_show_content(win, height, weight, start, current_ind, _content);
     bool flag_continue = true;
+    int ch;
     while(flag_continue) {
-        switch(getch()) {
+        switch(ch = wait_key()) {
             case KEY_RESIZE : {
                 flag_continue = false;
                 break;
@@ -1887,6 +2806,15 @@ void create_find_content_panel(std::vector<std::string>& _content, std::string&
                 find_show_content(win, height, weight, start, current_ind, _content);
                 break;
             }
+            case KEY_PPAGE :
+            case KEY_NPAGE :
+            case KEY_HOME :
+            case KEY_END :
+            case 'g' : {
+                find_pagination(ch, height, start, current_ind, _content);
+                find_show_content(win, height, weight, start, current_ind, _content);
+                break;
+            }
             case '\n' : {
                 flag_continue = false;
                 return_result = _content[current_ind];
@@ -1898,11 +2826,14 @@ void create_find_content_panel(std::vector<std::string>& _content, std::string&
             }
         }
     }
-    delwin(win);
+    close_overlay(win);
 }
 
 void find_pagination(size_t _direction, size_t _height, size_t &_start, size_t &_current_ind,
                      const std::vector<std::string> &_content) {
+    if (jump_pagination(_direction, _height - 2, _content.size(), _start, _current_ind)) {
+        return;
+    }
     if (_direction == KEY_UP) {
         if (_current_ind == 0) {
             _start = 0;
@@ -1924,7 +2855,6 @@ void find_pagination(size_t _direction, size_t _height, size_t &_start, size_t &
 
 void find_show_content(WINDOW *_win, size_t _height, size_t _weight, size_t _start, size_t _current_ind, std::vector<std::string>& _content) {
     werase(_win);
-    refresh();
     box(_win, 0, 0);
     wattron(_win, A_BOLD);
     mvwprintw(_win, 0, static_cast<int>(_weight - (strlen(" Find content "))) / 2, "%s", " Find content ");
@@ -1956,6 +2886,9 @@ bool find_collect_results(const std::string &_current_dir, std::string &_query,
         _query.erase(0, 1);
         for (const auto &entry: std::filesystem::recursive_directory_iterator(_current_dir,
                                                         std::filesystem::directory_options::skip_permission_denied)) {
+            if (background.is_stopping()) {
+                return false;
+            }
             try {
                 if (entry.path().extension() == _query) {
                     if ((entry.is_directory() && flag_dir) || (entry.is_symlink() && flag_lnk)
@@ -1974,6 +2907,9 @@ bool find_collect_results(const std::string &_current_dir, std::string &_query,
     } else {
         for (const auto &entry: std::filesystem::recursive_directory_iterator(_current_dir,
                                                                               std::filesystem::directory_options::skip_permission_denied)) {
+            if (background.is_stopping()) {
+                return false;
+            }
             std::string buffer_filename = entry.path().filename().string();
             for (size_t i = 0; i < buffer_filename.length(); ++i) {
                 buffer_filename[i] = tolower(buffer_filename[i]);
@@ -2080,7 +3016,6 @@ bool create_find_panel(const std::string &_current_dir, std::string& _query,
     set_field_buffer(fields[7], 0, OK_BUTTON);
     set_field_buffer(fields[8], 0, NO_BUTTON);
 
-    wrefresh(win);
     pos_form_cursor(my_form);
     wrefresh(win);
 
@@ -2094,7 +3029,7 @@ bool create_find_panel(const std::string &_current_dir, std::string& _query,
 
     free_form(my_form);
     delwin(subwin);
-    delwin(win);
+    close_overlay(win);
     return entry_flag;
 }
 
@@ -2128,7 +3063,7 @@ bool navigation_find_utility(WINDOW *_win, FORM *_form, FIELD **_fields,
 
     wrefresh(_win);
     while (true) {
-        switch (ch = getch()) {
+        switch (ch = wait_key()) {
             case '\t': {
                 form_driver(_form, REQ_NEXT_FIELD);
                 index_field = field_index(current_field(_form));
@@ -2227,7 +3162,7 @@ bool navigation_edit_permissions(WINDOW *_win, FORM *_form, FIELD **_fields, cha
     };
 
     while (true) {
-        switch (getch()) {
+        switch (wait_key()) {
             case '\t' : {
                 current_ind = field_index(current_field(_form));
                 if (current_ind == 0) {
@@ -2288,7 +3223,7 @@ bool navigation_functional_create_redact_panel(WINDOW *_win, FORM *_form,
         wrefresh(_win);
     }
     while (true) {
-        switch (ch = getch()) {
+        switch (ch = wait_key()) {
             case '\t': {
                 form_driver(_form, REQ_NEXT_FIELD);
                 index_field = field_index(current_field(_form));
@@ -2389,8 +3324,9 @@ void create_history_panel(std::string& return_result) {
     size_t current_ind = 0;
     history_show_content(win, height, weight, start, current_ind);
     bool flag_continue = true;
+    int ch;
     while(flag_continue) {
-        switch(getch()) {
+        switch(ch = wait_key()) {
             case KEY_RESIZE : {
                 flag_continue = false;
                 break;
@@ -2405,6 +3341,15 @@ void create_history_panel(std::string& return_result) {
                 history_show_content(win, height, weight, start, current_ind);
                 break;
             }
+            case KEY_PPAGE :
+            case KEY_NPAGE :
+            case KEY_HOME :
+            case KEY_END :
+            case 'g' : {
+                history_pagination(ch, height, start, current_ind);
+                history_show_content(win, height, weight, start, current_ind);
+                break;
+            }
             case '\n' : {
                 return_result = history_vec.history_path[current_ind];
                 flag_continue = false;
@@ -2416,12 +3361,11 @@ void create_history_panel(std::string& return_result) {
             }
         }
     }
-    delwin(win);
+    close_overlay(win);
 }
 
 void history_show_content(WINDOW* _win, size_t _height, size_t _weight, size_t _start, size_t _current_ind) {
     werase(_win);
-    refresh();
     box(_win, 0, 0);
     wattron(_win, A_BOLD);
     mvwprintw(_win, 0, static_cast<int>(_weight - (strlen(HISTORY_HEADER))) / 2, "%s", HISTORY_HEADER);
@@ -2447,6 +3391,9 @@ void history_show_content(WINDOW* _win, size_t _height, size_t _weight, size_t _
 }
 
 void history_pagination(size_t _direction, size_t _height, size_t &_start, size_t &_current_ind) {
+    if (jump_pagination(_direction, _height - 2, history_vec.history_path.size(), _start, _current_ind)) {
+        return;
+    }
     if (_direction == KEY_UP) {
         if (_current_ind == 0) {
             _start = 0;
@@ -2467,21 +3414,21 @@ void history_pagination(size_t _direction, size_t _height, size_t &_start, size_
 }
 
 void refresh_sub_panel(WINDOW *_win) {
-    wrefresh(_win);
-    refresh();
+    flush_overlay(_win);
 }
 
 void file_panel::analysis_selected_file() {
+    scoped_span span(SPAN_KIND::INFO);
     if (content[current_ind].content_type == CONTENT_TYPE::IS_HANGING_LINK) {
         return;
     }
     clear();
-    refresh();
+    wnoutrefresh(stdscr);
     WINDOW* info_win = newwin(LINES, COLS, 0, 0);
     wattron(info_win, COLOR_PAIR(10));
     mvwprintw(info_win, LINES - 1, 0, "%*s", COLS, " ");
     mvwprintw(info_win, 0, 0, "%*s", COLS, " ");
-    std::string file_message = "Information about: '" + content[current_ind].name_content + "'";
+    std::string file_message = "Information about: '" + std::string(content[current_ind].name_content) + "'";
     std::string continue_message = "Press any button to continue";
     mvwprintw(info_win, 0, static_cast<int>((COLS - file_message.length()) / 2), "%s", file_message.c_str());
     mvwprintw(info_win, LINES - 1, static_cast<int>((COLS - continue_message.length()) / 2), "%s", continue_message.c_str());
@@ -2492,12 +3439,12 @@ void file_panel::analysis_selected_file() {
     int start = (LINES - info_lines) / 2;
     std::string current_path_str;
     if (current_directory != "/") {
-        current_path_str = current_directory + "/" + content[current_ind].name_content;
+        current_path_str = current_directory + "/" + std::string(content[current_ind].name_content);
     } else {
-        current_path_str = current_directory + content[current_ind].name_content;
+        current_path_str = current_directory + std::string(content[current_ind].name_content);
     }
     std::string target_link;
-    std::filesystem::path current_path(current_directory + "/" + content[current_ind].name_content);
+    std::filesystem::path current_path(current_directory + "/" + std::string(content[current_ind].name_content));
     std::string type_and_name;
     if (is_directory(current_path) && !is_symlink(current_path)) {
         type_and_name += "Directory: ";
@@ -2576,7 +3523,7 @@ void file_panel::analysis_selected_file() {
     std::string filesystem_name = a[1].substr(0, a[1].find(' '));
     std::string file_system = "File system: " + filesystem_name + " (" + std::to_string(sb.st_dev) + ")";
     if (!target_link.empty()) {
-        type_and_name += content[current_ind].name_content + " -> " + target_link;
+        type_and_name += std::string(content[current_ind].name_content) + " -> " + target_link;
     } else {
         type_and_name += content[current_ind].name_content;
     }
@@ -2596,14 +3543,16 @@ void file_panel::analysis_selected_file() {
     mvwprintw(info_win, start, len, "%s", file_system.c_str());
     wattroff(info_win, COLOR_PAIR(GREEN_COLOR));
     wrefresh(info_win);
-    getch();
+    wait_key();
     werase(info_win);
     wrefresh(info_win);
-    delwin(info_win);
+    close_overlay(info_win);
 }
 
 void file_panel::set_current_directory(const std::string &_current_directory) {
+    remember_current_dir();
     current_directory = _current_directory;
+    chrome_dirty = true;
 }
 
 bool file_panel::is_active_panel() const {
@@ -2619,12 +3568,11 @@ void file_panel::set_start_ind(size_t _start_ind) {
 }
 
 void file_panel::calculate_size() {
-    uintmax_t size_bytes = 0;
     if (this->content[current_ind].content_type == CONTENT_TYPE::IS_DIR) {
         if (this->content[current_ind].name_content == "..") {
             return;
         }
-        std::filesystem::path current_path(this->current_directory + "/" + this->content[current_ind].name_content);
+        std::filesystem::path current_path(this->current_directory + "/" + std::string(this->content[current_ind].name_content));
         if ((status(current_path).permissions() & std::filesystem::perms::owner_read) == std::filesystem::perms::none) {
             std::string message = "Cannot calculate size from: '" + current_path.filename().string() + "'";
             create_error_panel(" Permission error ", message,
@@ -2633,21 +3581,37 @@ void file_panel::calculate_size() {
                                ? WEIGHT_FUNCTIONAL_PANEL : message.length() + 2);
             return;
         }
-        for (auto && entry : std::filesystem::recursive_directory_iterator(current_path, std::filesystem::directory_options::skip_permission_denied)) {
-            if (entry.is_regular_file() || entry.is_regular_file()
-            || entry.is_block_file() || entry.is_fifo() || entry.is_socket()) {
-                struct stat sb {};
-                lstat(entry.path().string().c_str(), &sb);
-                size_bytes += sb.st_size;
+        background.submit([current_path]() {
+            trace_clock::time_point start = trace_clock::now();
+            uintmax_t size_bytes = 0;
+            try {
+                for (auto &&entry : std::filesystem::recursive_directory_iterator(current_path, std::filesystem::directory_options::skip_permission_denied)) {
+                    if (background.is_stopping()) {
+                        return;
+                    }
+                    if (entry.is_regular_file() || entry.is_regular_file()
+                    || entry.is_block_file() || entry.is_fifo() || entry.is_socket()) {
+                        struct stat sb {};
+                        lstat(entry.path().string().c_str(), &sb);
+                        size_bytes += sb.st_size;
+                    }
+                }
+            } catch (std::filesystem::filesystem_error &e) {
+                // Entries that vanish mid-walk are skipped; the sum covers what was reached.
             }
-        }
-        create_calculate_panel(size_bytes, current_path.filename().string());
+            uint64_t duration = elapsed_ns(start, trace_clock::now());
+            background.post([current_path, start, duration, size_bytes]() {
+                ui_tracer.record(SPAN_KIND::SIZE, start, duration);
+                create_calculate_panel(size_bytes, current_path.filename().string());
+            });
+        });
     }
 }
 
 void filesystem_info_mount() {
+    scoped_span span(SPAN_KIND::INFO);
     clear();
-    refresh();
+    wnoutrefresh(stdscr);
     WINDOW* win = newwin(LINES, COLS, 0, 0);
     wattron(win, COLOR_PAIR(10));
     mvwprintw(win, LINES - 1, 0, "%*s", COLS, " ");
@@ -2689,10 +3653,10 @@ void filesystem_info_mount() {
     wattroff(win, COLOR_PAIR(GREEN_COLOR));
 
     wrefresh(win);
-    getch();
+    wait_key();
     werase(win);
     wrefresh(win);
-    delwin(win);
+    close_overlay(win);
 }
 
 bool is_input_field_find(size_t _index) {
@@ -2736,7 +3700,7 @@ void create_help_menu(char& _choice) {
     wrefresh(win);
     bool flag_continue = true;
     while(flag_continue) {
-        switch(getch()) {
+        switch(wait_key()) {
             case KEY_RESIZE : {
                 flag_continue = false;
                 break;
@@ -2757,12 +3721,11 @@ void create_help_menu(char& _choice) {
             }
         }
     }
-    delwin(win);
+    close_overlay(win);
 }
 
 void help_menu_show_content(WINDOW *_win, size_t _height, size_t _weight, size_t _start, size_t _current_ind) {
     werase(_win);
-    refresh();
     box(_win, 0, 0);
     wattron(_win, A_BOLD);
     mvwprintw(_win, 0, static_cast<int>(_weight - (strlen(" Help menu "))) / 2, "%s", " Help menu ");
@@ -2783,6 +3746,83 @@ void help_menu_show_content(WINDOW *_win, size_t _height, size_t _weight, size_t
     wattroff(_win, A_BOLD);
 }
 
+bool jump_pagination(size_t _direction, size_t _page, size_t _count, size_t &_start, size_t &_current_ind) {
+    if (_count == 0) {
+        return false;
+    }
+    switch (_direction) {
+        case KEY_HOME : {
+            jump_to_index(0, _page, _count, _start, _current_ind);
+            return true;
+        }
+        case KEY_END : {
+            jump_to_index(_count - 1, _page, _count, _start, _current_ind);
+            return true;
+        }
+        case KEY_PPAGE : {
+            jump_to_index(_current_ind > _page ? _current_ind - _page : 0, _page, _count, _start, _current_ind);
+            return true;
+        }
+        case KEY_NPAGE : {
+            jump_to_index(_current_ind + _page, _page, _count, _start, _current_ind);
+            return true;
+        }
+        case 'g' : {
+            size_t target;
+            if (prompt_jump_target(_count, target)) {
+                jump_to_index(target, _page, _count, _start, _current_ind);
+            }
+            return true;
+        }
+        default :
+            return false;
+    }
+}
+
+void jump_to_index(size_t _target, size_t _page, size_t _count, size_t &_start, size_t &_current_ind) {
+    _current_ind = _target < _count ? _target : _count - 1;
+    _start = _current_ind / _page * _page;
+}
+
+bool prompt_jump_target(size_t _count, size_t &_target) {
+    std::string input;
+    if (!create_redact_other_func_panel(HEADER_GO_TO, DESCRIPTION_GO_TO, input,
+                                        HEIGHT_FUNCTIONAL_PANEL, WEIGHT_FUNCTIONAL_PANEL)) {
+        return false;
+    }
+    return parse_jump_target(input, _count, _target);
+}
+
+bool parse_jump_target(const std::string &_input, size_t _count, size_t &_target) {
+    const char *begin = _input.c_str();
+    while (*begin == ' ') {
+        begin++;
+    }
+    char *end;
+    errno = 0;
+    unsigned long long value = strtoull(begin, &end, 10);
+    if (end == begin || errno == ERANGE || *begin == '-') {
+        return false;
+    }
+    while (*end == ' ') {
+        end++;
+    }
+    if (*end == '%') {
+        end++;
+        value = value >= 100 ? _count - 1 : value * (_count - 1) / 100;
+    } else if (value > 0) {
+        value--;
+    }
+    while (*end == ' ') {
+        end++;
+    }
+    if (*end != '\0') {
+        return false;
+    }
+    _target = value < _count ? static_cast<size_t>(value) : _count - 1;
+    return true;
+}
+
 void help_panel_pagination(size_t _direction, size_t _height, size_t &_start, size_t &_current_ind) {
     if (_direction == KEY_UP) {
         if (_current_ind == 0) {
@@ -2814,6 +3854,6 @@ void create_calculate_panel(uintmax_t size, const std::string& filename) {
     mvwprintw(win, 2, 3, "%s%s","File: ", filename.c_str());
     mvwprintw(win, 3, 3, "%s%zu%s", "Size: ", size, " bytes");
     wrefresh(win);
-    getch();
-    delwin(win);
+    wait_key();
+    close_overlay(win);
 }
@@ -17,6 +17,9 @@
 #include <grp.h>
 #include <sys/vfs.h>
 #include <mntent.h>
+#include <memory>
+#include <poll.h>
+#include <sys/inotify.h>
 
 #define DATE_LEN 16
 #define LEN_LINE_FIRST 36
@@ -34,6 +37,7 @@
 #define HEADER_MOVE " Move file(s) "
 #define HEADER_COPY " Copy file(s) "
 #define HEADER_DELETE " Delete file(s) "
+#define HEADER_GO_TO " Go to entry "
 #define OK_BUTTON "[ OK ]"
 #define NO_BUTTON "[ NO ]"
 #define YES_BUTTON "[ YES ]"
@@ -43,19 +47,31 @@
 #define DESCRIPTION_LINK_POINTER "Pointing to:"
 #define DESCRIPTION_FILE "Type file name:"
 #define DESCRIPTION_DIRECTORY "Type directory name:"
+#define DESCRIPTION_GO_TO "Entry number or percent (50%):"
 #define PRESS_ANY_BUTTON " Press any key to continue "
 #define EDIT_PERMISSIONS " Change file(s) permissions "
 #define HISTORY_HEADER " History switches "
 #define HEIGHT_FUNCTIONAL_PANEL 10
 #define WEIGHT_FUNCTIONAL_PANEL 60
 #define WEIGHT_HISTORY_PANEL 45
+#define NAME_ARENA_BLOCK_SIZE 65536
+#define NAME_ARENA_COMPACT_SLACK (1024 * 1024)
+#define SIZE_TEXT_BUFFER_LEN 24
+#define SORT_MODE_COUNT 5
+#define SORT_SLOT_COUNT (SORT_MODE_COUNT * 2)
+#define SORT_GROUP_COUNT 6
+#define SORT_SLOT_NONE SORT_SLOT_COUNT
+#define INOTIFY_BUFFER_SIZE 65536
+#define FRAME_BUDGET_MS 16
+#define INOTIFY_PANEL_MASK (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ATTRIB | IN_MODIFY \
+                            | IN_CLOSE_WRITE | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR | IN_EXCL_UNLINK)
 
 struct history_panel {
     std::vector<std::string> history_path;
     size_t max_len = 0;
 };
 
-enum class CONTENT_TYPE {
+enum class CONTENT_TYPE : unsigned char {
     IS_DIR = 0,
     IS_LNK_TO_DIR = 1,
     IS_LNK = 2,
@@ -70,6 +86,20 @@ enum COLOR_INDEX : short {
     BLUE_COLOR = 17,
     MAGENTA_COLOR = 18,
     RED_COLOR = 19,
+    CYAN_COLOR = 20,
+};
+
+enum class SORT_MODE : unsigned char {
+    BY_NAME = 0,
+    BY_NATURAL = 1,
+    BY_SIZE = 2,
+    BY_MTIME = 3,
+    BY_EXTENSION = 4,
+};
+
+struct sort_order {
+    SORT_MODE mode = SORT_MODE::BY_NAME;
+    bool reverse = false;
 };
 
 enum class REMOVE_TYPE {
@@ -79,6 +109,11 @@ enum class REMOVE_TYPE {
     STOP_REMOVE = 3,
 };
 
+enum class COPY_BACKEND : unsigned char {
+    SYSCALL = 0,
+    URING = 1,
+};
+
 typedef struct char_permissions {
     std::string owner_perm;
     std::string group_perm;
@@ -87,38 +122,159 @@ typedef struct char_permissions {
 } char_permissions;
 
 struct info {
-    std::string name_content;
-    std::string last_redact_content;
-    CONTENT_TYPE content_type;
+    std::string_view name_content;
+    int64_t modify_time;
     ssize_t size_content;
+    CONTENT_TYPE content_type;
     COLOR_INDEX color_index;
+    uint32_t id;
 
     info(std::string_view _name_content,
-         std::string_view _last_redact_content,
-         ssize_t _current_ind, CONTENT_TYPE _content_type,
+         int64_t _modify_time,
+         ssize_t _size_content, CONTENT_TYPE _content_type,
          COLOR_INDEX _color_index);
 };
 
+class name_arena {
+private:
+    std::vector<std::unique_ptr<char[]>> blocks;
+    size_t block_used;
+    size_t block_capacity;
+    size_t total_bytes;
+public:
+    name_arena();
+    std::string_view store(std::string_view _name);
+    [[nodiscard]] size_t bytes() const;
+};
+
+class listing {
+private:
+    std::vector<info> entries;
+    std::shared_ptr<name_arena> arena;
+    size_t live_bytes;
+    uint32_t next_id;
+    size_t current_slot;
+    std::vector<std::vector<uint32_t>> permutations;
+    uint64_t stamp;
+    void touch();
+public:
+    using iterator = std::vector<info>::iterator;
+    using const_iterator = std::vector<info>::const_iterator;
+    listing();
+    void adopt_arena(std::shared_ptr<name_arena> _arena);
+    std::string_view intern(std::string_view _name);
+    void push_back(const info& _entry);
+    iterator insert(const_iterator _pos, const info& _entry);
+    iterator erase(const_iterator _pos);
+    iterator erase(const_iterator _first, const_iterator _last);
+    void reserve(size_t _count);
+    void clear();
+    void compact();
+    void apply_permutation(const std::vector<uint32_t>& _order);
+    bool restore_permutation(size_t _slot);
+    void remember_permutation(size_t _slot);
+    void invalidate_permutations();
+    [[nodiscard]] size_t position_of(uint32_t _id) const;
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] bool empty() const;
+    [[nodiscard]] size_t bytes() const;
+    [[nodiscard]] uint64_t get_stamp() const;
+    info& operator[](size_t _ind);
+    const info& operator[](size_t _ind) const;
+    iterator begin();
+    iterator end();
+    [[nodiscard]] const_iterator begin() const;
+    [[nodiscard]] const_iterator end() const;
+};
+
+struct row_text {
+    uint32_t id;
+    std::string name;
+    char size[SIZE_TEXT_BUFFER_LEN];
+    int size_len;
+    size_t width;
+    size_t generation;
+};
+
+class row_text_cache {
+private:
+    std::vector<row_text> rows;
+    size_t generation;
+public:
+    row_text_cache();
+    const row_text& get(size_t _slot, const info& _entry, size_t _width);
+    void invalidate(uint32_t _id);
+    void clear();
+};
+
+class metadata_loader;
+class name_index;
+class job_progress;
+
+extern size_t overlay_epoch;
+
 class file_panel {
 private:
     std::string current_directory;
 private:
     WINDOW* win;
-    std::vector<info> content;
+    listing content;
     bool active_panel;
     PANEL* panel;
     size_t start_index;
     size_t current_ind;
+    std::unique_ptr<metadata_loader> loader;
+    std::unique_ptr<name_index> names;
+    std::string search_prefix;
+    bool searching;
+    bool status_dirty;
+    bool resort_pending;
+    sort_order active_order;
+    COPY_BACKEND copy_backend;
+    bool verify_copies;
+    int inotify_fd;
+    int watch_descriptor;
+    std::string watched_directory;
+    struct stat listing_stat;
+    row_text_cache row_texts;
+    bool chrome_dirty;
+    bool rows_dirty;
+    std::vector<size_t> dirty_rows;
+    size_t drawn_epoch;
+    bool drawn_active;
+    size_t drawn_start;
+    size_t drawn_cursor;
+    size_t drawn_count;
+    bool drawn_trace;
+    void display_row(size_t _row);
+    void display_status();
+    void mark_row_dirty(size_t _ind);
+    void sort_content();
+    void sort_keeping_cursor();
+    void store_in_cache();
+    void reload_current_dir();
+    void remember_current_dir();
+    void resolve_pending_entry(size_t _ind);
+    void watch_current_dir();
+    bool apply_fs_events();
+    void update_entries(int _dirfd, const std::vector<std::string>& _names);
+    [[nodiscard]] size_t find_entry(const std::string& _name) const;
 public :
     file_panel() = delete;
     ~file_panel();
     explicit file_panel(std::string_view _current_directory, size_t _rows,
                         size_t _cols, size_t _x, size_t _y);
-    [[nodiscard]] const std::vector<info>& get_content() const;
+    [[nodiscard]] const listing& get_content() const;
     [[nodiscard]] PANEL* get_panel() const;
     [[nodiscard]] size_t get_current_ind() const;
     [[nodiscard]] const std::string& get_current_directory() const;
     [[nodiscard]] bool is_active_panel() const;
+    [[nodiscard]] sort_order get_sort_order() const;
+    void set_sort_order(sort_order _order);
+    [[nodiscard]] COPY_BACKEND get_copy_backend() const;
+    void set_copy_backend(COPY_BACKEND _backend);
+    [[nodiscard]] bool get_verify_copies() const;
+    void set_verify_copies(bool _verify);
     void set_current_ind(size_t _current_ind);
     void set_start_ind(size_t _start_ind);
     void set_current_directory(const std::string &_current_directory);
@@ -126,30 +282,61 @@ public :
     void display_current_dir();
     void set_active_panel(bool _active_panel);
     void move_cursor_and_pagination(size_t _direction);
+    void jump_to(size_t _ind);
+    void go_to_entry();
+    void select_entry_or_clamp(const std::string& _name);
+    void start_quick_search();
+    bool quick_search_key(int _ch);
+    [[nodiscard]] bool is_quick_searching() const;
     void display_headers();
     void read_current_dir();
+    void refresh_content();
+    void collect_poll_fds(std::vector<pollfd>& _fds) const;
+    bool process_events();
     void display_lines();
     void switch_directory(const std::string& _direction);
     void refresh_panels();
     void resize_panel(size_t _rows, size_t _cols, size_t _x, size_t _y);
     void display_content();
+    void render();
     void calculate_size();
     void edit_permissions(file_panel& _other_panel);
     void create_symlink(file_panel& _other_panel);
     void create_file(file_panel& _other_panel);
     void create_directory(file_panel& _other_panel);
     void delete_content(file_panel& _other_panel);
-    void sequential_removing(std::filesystem::path& _p, file_panel& _other_panel, bool _all);
+    void sequential_removing(const std::filesystem::path& _p, file_panel& _other_panel,
+                             const std::string& _name, bool _all, job_progress& _job);
+    void finish_removing(file_panel& _other_panel, const std::string& _removed_path);
     void copy_content(file_panel& _other_panel);
     void move_content(file_panel& _other_panel);
     void rename_content(file_panel& _other_panel);
-    void overwrite_content_copy(file_panel& _other_panel, std::filesystem::path& _from, std::filesystem::path& _to, bool _all);
-    void overwrite_content_move(file_panel& _other_panel, std::filesystem::path& _from, std::filesystem::path& _to);
+    void overwrite_content_copy(file_panel& _other_panel, const std::filesystem::path& _from,
+                                const std::filesystem::path& _to, const std::string& _name, bool _all,
+                                COPY_BACKEND _backend, job_progress& _job);
+    void overwrite_content_move(file_panel& _other_panel, const std::filesystem::path& _from,
+                                const std::filesystem::path& _to, const std::string& _name, job_progress& _job);
+    void start_copy_tree(file_panel& _other_panel, const std::filesystem::path& _from,
+                         const std::filesystem::path& _to, bool _all);
+    void start_copy_file(file_panel& _other_panel, const std::filesystem::path& _from,
+                         const std::filesystem::path& _to, std::filesystem::copy_options _options);
+    void start_move_tree(file_panel& _other_panel, const std::filesystem::path& _from,
+                         const std::filesystem::path& _to);
+    void report_mismatches(const job_progress& _job);
+    void start_chmod_tree(file_panel& _other_panel, const std::filesystem::path& _path,
+                          std::filesystem::perms _perms);
+    void refresh_if_showing(file_panel& _other_panel, const std::string& _directory);
     void analysis_selected_file();
 };
 
 void generate_incompatible_error(std::filesystem::filesystem_error& e);
 void generate_permission_error(std::filesystem::filesystem_error& e);
+REMOVE_TYPE ask_remove_panel(file_panel& _first, file_panel& _second, const std::string& _header,
+                             const std::string& _message, int _height, int _weight);
+void report_filesystem_error(file_panel& _first, file_panel& _second, const std::filesystem::filesystem_error& e);
+void flush_frame();
+void flush_overlay(WINDOW* _win);
+void close_overlay(WINDOW* _win);
 WINDOW* create_functional_panel(const std::string& _header, int _height, int _weight);
 void init_colors();
 void convert_to_output(std::string& _name, CONTENT_TYPE _type);
@@ -183,6 +370,7 @@ bool navigation_find_utility(WINDOW* _win, FORM* _form, FIELD** _fields,
                              const std::string& _dir,
                              char& _take_reg, char& _take_dir, char& _take_lnk,
                              char_permissions& _str_perms, std::string& _result);
+void show_find_results(file_panel& first, file_panel& second, std::vector<std::string>& results, bool is_good_query);
 bool find_collect_results(const std::string& _current_dir, std::string& _query, std::vector<std::string>& _results,
                           bool, bool, bool, bool, std::filesystem::perms&);
 void find_utility(file_panel& _first, file_panel& _second, const std::string& _current_dir);
@@ -198,6 +386,10 @@ void convert_str_to_window_size(std::string& _to, std::string& _from, size_t win
 void create_help_menu(char& _choice);
 void help_panel_pagination(size_t _direction, size_t _height, size_t& _start,
                      size_t& _current_ind);
+bool jump_pagination(size_t _direction, size_t _page, size_t _count, size_t& _start, size_t& _current_ind);
+void jump_to_index(size_t _target, size_t _page, size_t _count, size_t& _start, size_t& _current_ind);
+bool prompt_jump_target(size_t _count, size_t& _target);
+bool parse_jump_target(const std::string& _input, size_t _count, size_t& _target);
 void create_calculate_panel(uintmax_t size, const std::string& filename);
 
 #endif //COURSE_PROJECT_FILE_PANEL_H
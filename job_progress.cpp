@@ -0,0 +1,668 @@
+#include <cstdio>
+#include <cstring>
+#include <stack>
+#include "job_progress.h"
+#include "file_panel.h"
+#include "job_queue.h"
+
+progress_board job_board;
+
+const char *job_kind_label(JOB_KIND _kind) {
+    switch (_kind) {
+        case JOB_KIND::COPY : return "Copy";
+        case JOB_KIND::MOVE : return "Move";
+        case JOB_KIND::DELETE : return "Delete";
+        case JOB_KIND::CHMOD : return "Chmod";
+        default : return "?";
+    }
+}
+
+const char *job_state_label(JOB_STATE _state) {
+    switch (_state) {
+        case JOB_STATE::QUEUED : return "Queued";
+        case JOB_STATE::RUNNING : return "Running";
+        case JOB_STATE::PAUSED : return "Paused";
+        case JOB_STATE::CANCELLED : return "Cancelled";
+        case JOB_STATE::DONE : return "Done";
+        default : return "?";
+    }
+}
+
+std::string format_bytes(double _bytes) {
+    static const char *units[] = {"B", "KB", "MB", "GB", "TB"};
+    size_t unit = 0;
+    while (_bytes >= 1024.0 && unit + 1 < sizeof(units) / sizeof(units[0])) {
+        _bytes /= 1024.0;
+        unit++;
+    }
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), unit == 0 ? "%.0f %s" : "%.1f %s", _bytes, units[unit]);
+    return buffer;
+}
+
+static std::string format_duration(double _seconds) {
+    auto total = static_cast<uint64_t>(_seconds + 0.5);
+    char buffer[32];
+    if (total >= 3600) {
+        snprintf(buffer, sizeof(buffer), "%lu:%02lu:%02lu", total / 3600, total / 60 % 60, total % 60);
+    } else {
+        snprintf(buffer, sizeof(buffer), "%lu:%02lu", total / 60, total % 60);
+    }
+    return buffer;
+}
+
+static int64_t steady_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(trace_clock::now().time_since_epoch()).count();
+}
+
+job_progress::job_progress(JOB_KIND _kind, std::string _name, std::filesystem::path _root,
+                           descend_function _descend, std::vector<dev_t> _devices)
+        : priority(0), start_ns(0), total_files(0), total_bytes(0), scanned(false), done_files(0), done_bytes(0),
+          written_bytes(0), paused(false), cancelled(false), finished(false), finish_ns(0), verify(false), verified_files(0) {
+    this->kind = _kind;
+    this->name = std::move(_name);
+    this->root = std::move(_root);
+    this->descend = std::move(_descend);
+    this->devices = std::move(_devices);
+    this->sampled = false;
+    this->sample_files = 0;
+    this->sample_bytes = 0;
+    this->files_rate = 0.0;
+    this->bytes_rate = 0.0;
+}
+
+job_progress::~job_progress() {
+    finish();
+}
+
+void job_progress::start() {
+    start_ns.store(steady_now_ns());
+    scanner = std::thread(&job_progress::scan, this);
+}
+
+void job_progress::scan() {
+    bool count_directories = kind != JOB_KIND::COPY;
+    struct stat root_stat {};
+    if (lstat(root.c_str(), &root_stat) == 0 && !S_ISDIR(root_stat.st_mode)) {
+        total_files.store(1);
+        total_bytes.store(S_ISREG(root_stat.st_mode) ? static_cast<uint64_t>(root_stat.st_size) : 0);
+        scanned.store(true);
+        return;
+    }
+    std::stack<std::filesystem::path> dir_stack;
+    dir_stack.push(root);
+    while (!dir_stack.empty()) {
+        std::filesystem::path current_path = dir_stack.top();
+        dir_stack.pop();
+        try {
+            for (const auto &entry: std::filesystem::directory_iterator(current_path,
+                                                                        std::filesystem::directory_options::skip_permission_denied)) {
+                if (finished.load(std::memory_order_relaxed) || cancelled.load(std::memory_order_relaxed)) {
+                    return;
+                }
+                struct stat sb {};
+                if (lstat(entry.path().c_str(), &sb) == -1) {
+                    continue;
+                }
+                if (S_ISDIR(sb.st_mode)) {
+                    bool enter = !descend || descend(entry);
+                    // remove_all and chmod count a directory with its contents;
+                    // a move counts only the directories it renames, not the
+                    // ones it enters.
+                    if (count_directories && (kind != JOB_KIND::MOVE || !enter)) {
+                        total_files.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    if (enter) {
+                        dir_stack.push(entry.path());
+                    }
+                } else if (count_directories || !S_ISLNK(sb.st_mode)) {
+                    total_files.fetch_add(1, std::memory_order_relaxed);
+                    if (!count_directories && S_ISREG(sb.st_mode)) {
+                        total_bytes.fetch_add(static_cast<uint64_t>(sb.st_size), std::memory_order_relaxed);
+                    }
+                }
+            }
+        } catch (std::filesystem::filesystem_error &e) {
+            // The job itself reports what it cannot reach; the totals just miss it.
+        }
+    }
+    scanned.store(true);
+}
+
+void job_progress::add_files(uint64_t _files) {
+    done_files.fetch_add(_files, std::memory_order_relaxed);
+}
+
+void job_progress::add_bytes(uint64_t _bytes) {
+    done_bytes.fetch_add(_bytes, std::memory_order_relaxed);
+}
+
+void job_progress::add_written(uint64_t _bytes) {
+    written_bytes.fetch_add(_bytes, std::memory_order_relaxed);
+}
+
+std::atomic<uint64_t> *job_progress::get_byte_counter() {
+    return &done_bytes;
+}
+
+void job_progress::enable_verify() {
+    verify.store(true);
+}
+
+void job_progress::add_verified(uint64_t _files) {
+    verified_files.fetch_add(_files, std::memory_order_relaxed);
+}
+
+void job_progress::add_mismatch(const std::string &_mismatch) {
+    std::lock_guard<std::mutex> lock(mismatch_mutex);
+    mismatches.push_back(_mismatch);
+}
+
+bool job_progress::is_verifying() const {
+    return verify.load();
+}
+
+std::vector<std::string> job_progress::get_mismatches() const {
+    std::lock_guard<std::mutex> lock(mismatch_mutex);
+    return mismatches;
+}
+
+std::string job_progress::verify_note() const {
+    if (!verify.load()) {
+        return "";
+    }
+    size_t failed;
+    {
+        std::lock_guard<std::mutex> lock(mismatch_mutex);
+        failed = mismatches.size();
+    }
+    std::string note = ", verified " + std::to_string(verified_files.load(std::memory_order_relaxed));
+    return failed == 0 ? note : note + ", " + std::to_string(failed) + " MISMATCHED";
+}
+
+bool job_progress::checkpoint() {
+    if (paused.load(std::memory_order_relaxed) && !cancelled.load()) {
+        std::unique_lock<std::mutex> lock(pause_mutex);
+        pause_wake.wait(lock, [this]() { return !paused.load() || cancelled.load(); });
+    }
+    return !cancelled.load(std::memory_order_relaxed);
+}
+
+void job_progress::pause() {
+    paused.store(true);
+}
+
+void job_progress::resume() {
+    {
+        std::lock_guard<std::mutex> lock(pause_mutex);
+        paused.store(false);
+    }
+    pause_wake.notify_all();
+}
+
+void job_progress::cancel() {
+    {
+        std::lock_guard<std::mutex> lock(pause_mutex);
+        cancelled.store(true);
+    }
+    pause_wake.notify_all();
+}
+
+void job_progress::finish() {
+    if (!finished.exchange(true)) {
+        int64_t started = start_ns.load();
+        finish_ns.store(started == 0 ? 0 : static_cast<uint64_t>(steady_now_ns() - started));
+    }
+    if (scanner.joinable()) {
+        scanner.join();
+    }
+}
+
+void job_progress::sample(trace_clock::time_point _now) {
+    int64_t started = start_ns.load();
+    if (started == 0) {
+        return;
+    }
+    bool first = !sampled;
+    if (first) {
+        sampled = true;
+        sample_time = trace_clock::time_point(std::chrono::duration_cast<trace_clock::duration>(
+                std::chrono::nanoseconds(started)));
+    }
+    double seconds = static_cast<double>(elapsed_ns(sample_time, _now)) / 1e9;
+    if (seconds <= 0.0) {
+        return;
+    }
+    uint64_t files = done_files.load(std::memory_order_relaxed);
+    uint64_t bytes = done_bytes.load(std::memory_order_relaxed);
+    double current_files = static_cast<double>(files - sample_files) / seconds;
+    double current_bytes = static_cast<double>(bytes - sample_bytes) / seconds;
+    files_rate = first ? current_files : files_rate + PROGRESS_RATE_SMOOTHING * (current_files - files_rate);
+    bytes_rate = first ? current_bytes : bytes_rate + PROGRESS_RATE_SMOOTHING * (current_bytes - bytes_rate);
+    sample_time = _now;
+    sample_files = files;
+    sample_bytes = bytes;
+}
+
+void job_progress::set_priority(int _priority) {
+    priority.store(_priority);
+}
+
+int job_progress::get_priority() const {
+    return priority.load();
+}
+
+const std::vector<dev_t> &job_progress::get_devices() const {
+    return devices;
+}
+
+JOB_KIND job_progress::get_kind() const {
+    return kind;
+}
+
+JOB_STATE job_progress::get_state() const {
+    if (cancelled.load()) {
+        return JOB_STATE::CANCELLED;
+    }
+    if (finished.load()) {
+        return JOB_STATE::DONE;
+    }
+    if (paused.load()) {
+        return JOB_STATE::PAUSED;
+    }
+    return start_ns.load() == 0 ? JOB_STATE::QUEUED : JOB_STATE::RUNNING;
+}
+
+bool job_progress::is_paused() const {
+    return paused.load();
+}
+
+bool job_progress::is_cancelled() const {
+    return cancelled.load();
+}
+
+uint64_t job_progress::get_done_files() const {
+    return done_files.load();
+}
+
+uint64_t job_progress::get_done_bytes() const {
+    return done_bytes.load();
+}
+
+uint64_t job_progress::get_elapsed_ns() const {
+    if (finished.load()) {
+        return finish_ns.load();
+    }
+    int64_t started = start_ns.load();
+    return started == 0 ? 0 : static_cast<uint64_t>(steady_now_ns() - started);
+}
+
+double job_progress::fraction() const {
+    uint64_t files = done_files.load(std::memory_order_relaxed);
+    uint64_t bytes = done_bytes.load(std::memory_order_relaxed);
+    uint64_t all_files = total_files.load(std::memory_order_relaxed);
+    uint64_t all_bytes = total_bytes.load(std::memory_order_relaxed);
+    bool by_bytes = kind == JOB_KIND::COPY && all_bytes > 0;
+    double result = by_bytes ? static_cast<double>(bytes) / static_cast<double>(all_bytes)
+                             : all_files == 0 ? 0.0 : static_cast<double>(files) / static_cast<double>(all_files);
+    // The scan may still be behind the job, or miss entries created meanwhile.
+    return result > 1.0 ? 1.0 : result;
+}
+
+std::string job_progress::progress_line(size_t _bar_width) const {
+    double done = fraction();
+    auto filled = static_cast<size_t>(done * static_cast<double>(_bar_width));
+    std::string line = std::string(job_kind_label(kind)) + " " + name + " [" + std::string(filled, '#')
+                       + std::string(_bar_width - filled, '.') + "] ";
+    char percent[8];
+    snprintf(percent, sizeof(percent), "%3d%%", static_cast<int>(done * 100.0));
+    return line + percent;
+}
+
+std::string job_progress::rate_line() const {
+    JOB_STATE state = get_state();
+    if (state == JOB_STATE::QUEUED) {
+        char waiting[48];
+        snprintf(waiting, sizeof(waiting), "Waiting for the device, priority %+d", priority.load());
+        return waiting;
+    }
+    uint64_t files = done_files.load(std::memory_order_relaxed);
+    uint64_t bytes = done_bytes.load(std::memory_order_relaxed);
+    uint64_t all_files = total_files.load(std::memory_order_relaxed);
+    uint64_t all_bytes = total_bytes.load(std::memory_order_relaxed);
+    bool is_scanned = scanned.load(std::memory_order_relaxed);
+    const char *unit = kind == JOB_KIND::COPY ? "files" : "items";
+    std::string line = std::to_string(files) + "/" + std::to_string(all_files) + (is_scanned ? " " : "+ ") + unit;
+    if (kind == JOB_KIND::COPY) {
+        line += "  " + format_bytes(static_cast<double>(bytes)) + "/" + format_bytes(static_cast<double>(all_bytes))
+                + (is_scanned ? "" : "+") + "  " + format_bytes(bytes_rate) + "/s";
+    }
+    if (verify.load()) {
+        // Takes the place of the file rate, which the byte rate covers well enough.
+        line += "  verified " + std::to_string(verified_files.load(std::memory_order_relaxed));
+    } else {
+        char rate[32];
+        snprintf(rate, sizeof(rate), "  %.0f %s/s", files_rate, unit);
+        line += rate;
+    }
+    if (state == JOB_STATE::PAUSED) {
+        return line + "  Paused";
+    }
+    double remaining_seconds = -1.0;
+    if (is_scanned) {
+        if (kind == JOB_KIND::COPY && all_bytes > 0 && bytes_rate > 0.0) {
+            remaining_seconds = static_cast<double>(all_bytes > bytes ? all_bytes - bytes : 0) / bytes_rate;
+        } else if (files_rate > 0.0) {
+            remaining_seconds = static_cast<double>(all_files > files ? all_files - files : 0) / files_rate;
+        }
+    }
+    return line + "  ETA " + (remaining_seconds < 0.0 ? std::string("--:--") : format_duration(remaining_seconds));
+}
+
+std::string job_progress::status_line() const {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%-9s %+3d  %-6s %3d%%  ", job_state_label(get_state()), priority.load(),
+             job_kind_label(kind), static_cast<int>(fraction() * 100.0));
+    return buffer + name;
+}
+
+std::string job_progress::summary() const {
+    double seconds = static_cast<double>(get_elapsed_ns()) / 1e9;
+    uint64_t files = done_files.load();
+    const char *verb = kind == JOB_KIND::COPY ? "Copied " : kind == JOB_KIND::MOVE ? "Moved "
+                       : kind == JOB_KIND::DELETE ? "Deleted " : "Changed ";
+    char buffer[192];
+    if (kind == JOB_KIND::COPY) {
+        uint64_t bytes = done_bytes.load();
+        snprintf(buffer, sizeof(buffer), "%s%lu files%s, %s / %s written in %.2f s, avg %s/s, %.0f files/s", verb,
+                 files, verify_note().c_str(), format_bytes(static_cast<double>(bytes)).c_str(),
+                 format_bytes(static_cast<double>(written_bytes.load())).c_str(), seconds,
+                 format_bytes(seconds > 0.0 ? static_cast<double>(bytes) / seconds : 0.0).c_str(),
+                 seconds > 0.0 ? static_cast<double>(files) / seconds : 0.0);
+    } else {
+        snprintf(buffer, sizeof(buffer), "%s%lu items in %.2f s, avg %.0f items/s", verb, files, seconds,
+                 seconds > 0.0 ? static_cast<double>(files) / seconds : 0.0);
+    }
+    return std::string(buffer) + ": " + name + (cancelled.load() ? " (cancelled)" : "");
+}
+
+progress_board::progress_board() {
+    this->summary_until = trace_clock::now();
+    this->next_draw = this->summary_until;
+    this->win = nullptr;
+    this->panel = nullptr;
+    this->drawn_y = 0;
+    this->drawn_height = 0;
+    this->drawn_width = 0;
+}
+
+std::shared_ptr<job_progress> progress_board::begin(JOB_KIND _kind, const std::string &_name,
+                                                    const std::filesystem::path &_root,
+                                                    const std::vector<std::filesystem::path> &_touched,
+                                                    job_progress::descend_function _descend) {
+    std::vector<dev_t> devices;
+    for (auto &&path: _touched) {
+        struct stat sb {};
+        if (stat(path.c_str(), &sb) == 0
+            && std::find(devices.begin(), devices.end(), sb.st_dev) == devices.end()) {
+            devices.push_back(sb.st_dev);
+        }
+    }
+    auto job = std::make_shared<job_progress>(_kind, _name, _root, std::move(_descend), std::move(devices));
+    jobs.push_back(job);
+    next_draw = trace_clock::now();
+    return job;
+}
+
+void progress_board::end(const std::shared_ptr<job_progress> &_job) {
+    jobs.erase(std::remove(jobs.begin(), jobs.end(), _job), jobs.end());
+    last_summary = _job->summary();
+    next_draw = trace_clock::now();
+    summary_until = next_draw + std::chrono::milliseconds(PROGRESS_SUMMARY_MS);
+}
+
+const std::vector<std::shared_ptr<job_progress>> &progress_board::get_jobs() const {
+    return jobs;
+}
+
+int progress_board::wait_ms() const {
+    trace_clock::time_point wake;
+    if (!jobs.empty()) {
+        wake = next_draw;
+    } else if (win != nullptr || !last_summary.empty()) {
+        wake = next_draw < summary_until ? next_draw : summary_until;
+    } else {
+        return -1;
+    }
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(wake - trace_clock::now()).count();
+    return remaining > 0 ? static_cast<int>(remaining) : 0;
+}
+
+bool progress_board::tick() {
+    trace_clock::time_point now = trace_clock::now();
+    if (jobs.empty() && !last_summary.empty() && now >= summary_until) {
+        last_summary.clear();
+        close_panel();
+        return true;
+    }
+    if ((jobs.empty() && last_summary.empty()) || now < next_draw) {
+        return false;
+    }
+    next_draw = now + std::chrono::milliseconds(PROGRESS_REFRESH_MS);
+    // Started jobs first; the queued ones are listed in full in the jobs panel.
+    std::vector<job_progress*> shown;
+    for (auto &&job: jobs) {
+        job->sample(now);
+        if (job->get_state() != JOB_STATE::QUEUED) {
+            shown.push_back(job.get());
+        }
+    }
+    for (auto &&job: jobs) {
+        if (job->get_state() == JOB_STATE::QUEUED) {
+            shown.push_back(job.get());
+        }
+    }
+    if (shown.size() > PROGRESS_MAX_JOBS) {
+        shown.resize(PROGRESS_MAX_JOBS);
+    }
+    int height = static_cast<int>(2 + shown.size() * 2 + (last_summary.empty() ? 0 : 1));
+    int width = COLS - 4 < PROGRESS_PANEL_WIDTH ? COLS - 4 : PROGRESS_PANEL_WIDTH;
+    int y = LINES - 2 - height;
+    if (win != nullptr && (height != drawn_height || width != drawn_width || y != drawn_y)) {
+        close_panel();
+    }
+    if (win == nullptr) {
+        win = newwin(height, width, y, (COLS - width) / 2);
+        panel = new_panel(win);
+        drawn_y = y;
+        drawn_height = height;
+        drawn_width = width;
+    }
+    werase(win);
+    wbkgd(win, COLOR_PAIR(4));
+    box(win, 0, 0);
+    wattron(win, COLOR_PAIR(5) | A_BOLD);
+    std::string header = jobs.size() > shown.size()
+                         ? std::string(" Jobs (") + std::to_string(jobs.size()) + ") " : HEADER_PROGRESS;
+    mvwprintw(win, 0, (width - static_cast<int>(header.length())) / 2, "%s", header.c_str());
+    wattroff(win, COLOR_PAIR(5) | A_BOLD);
+    int text_width = width - 4;
+    int row = 1;
+    for (auto &&job: shown) {
+        // The bar takes what is left of the row after the label and percentage.
+        std::string label_probe = job->progress_line(0);
+        int bar_width = text_width - static_cast<int>(label_probe.length());
+        std::string line = job->progress_line(bar_width > 10 ? static_cast<size_t>(bar_width) : 10);
+        mvwprintw(win, row++, 2, "%.*s", text_width, line.c_str());
+        mvwprintw(win, row++, 2, "%.*s", text_width, job->rate_line().c_str());
+    }
+    if (!last_summary.empty()) {
+        mvwprintw(win, row, 2, "%.*s", text_width, last_summary.c_str());
+    }
+    return true;
+}
+
+void progress_board::close_panel() {
+    if (win == nullptr) {
+        return;
+    }
+    del_panel(panel);
+    delwin(win);
+    panel = nullptr;
+    win = nullptr;
+    overlay_epoch++;
+}
+
+void progress_board::close() {
+    close_panel();
+}
+
+static void jobs_show_content(WINDOW *_win, int _height, int _weight, size_t _current_ind) {
+    const auto &jobs = job_board.get_jobs();
+    werase(_win);
+    box(_win, 0, 0);
+    wattron(_win, A_BOLD);
+    mvwprintw(_win, 0, (_weight - static_cast<int>(strlen(HEADER_PROGRESS))) / 2, "%s", HEADER_PROGRESS);
+    mvwprintw(_win, _height - 1, (_weight - static_cast<int>(strlen(JOBS_PANEL_HINT))) / 2, "%s", JOBS_PANEL_HINT);
+    if (jobs.empty()) {
+        mvwprintw(_win, 1, 2, "%s", "No jobs.");
+    }
+    int rows = _height - 4;
+    size_t start = _current_ind >= static_cast<size_t>(rows) ? _current_ind - rows + 1 : 0;
+    trace_clock::time_point now = trace_clock::now();
+    for (size_t i = start; i < jobs.size() && i < start + rows; i++) {
+        jobs[i]->sample(now);
+        if (i == _current_ind) {
+            wattron(_win, A_REVERSE);
+        }
+        mvwprintw(_win, static_cast<int>(1 + i - start), 1, "%*s", _weight - 2, " ");
+        mvwprintw(_win, static_cast<int>(1 + i - start), 2, "%.*s", _weight - 4, jobs[i]->status_line().c_str());
+        wattroff(_win, A_REVERSE);
+    }
+    if (_current_ind < jobs.size()) {
+        mvwprintw(_win, _height - 2, 2, "%.*s", _weight - 4, jobs[_current_ind]->rate_line().c_str());
+    }
+    wattroff(_win, A_BOLD);
+    wrefresh(_win);
+}
+
+void create_jobs_panel() {
+    int height = JOBS_PANEL_HEIGHT;
+    int weight = COLS - 6 < PROGRESS_PANEL_WIDTH ? COLS - 6 : PROGRESS_PANEL_WIDTH;
+    WINDOW *win = newwin(height, weight, (LINES - height) / 2, (COLS - weight) / 2);
+    wbkgd(win, COLOR_PAIR(6));
+    size_t current_ind = 0;
+    bool flag_continue = true;
+    // Completions wait while the panel is open, so the list stays put; only
+    // the counters move, and they are redrawn on every timeout.
+    timeout(PROGRESS_REFRESH_MS);
+    while (flag_continue) {
+        const auto &jobs = job_board.get_jobs();
+        jobs_show_content(win, height, weight, current_ind);
+        int ch = wait_key();
+        if (ch == ERR) {
+            continue;
+        }
+        std::shared_ptr<job_progress> selected = current_ind < jobs.size() ? jobs[current_ind] : nullptr;
+        switch (ch) {
+            case KEY_UP : {
+                if (current_ind > 0) {
+                    current_ind--;
+                }
+                break;
+            }
+            case KEY_DOWN : {
+                if (current_ind + 1 < jobs.size()) {
+                    current_ind++;
+                }
+                break;
+            }
+            case 'p' : {
+                if (selected) {
+                    selected->is_paused() ? selected->resume() : selected->pause();
+                    file_jobs.reschedule();
+                }
+                break;
+            }
+            case 'c' : {
+                if (selected) {
+                    selected->cancel();
+                    file_jobs.reschedule();
+                }
+                break;
+            }
+            case '+' :
+            case '-' : {
+                if (selected) {
+                    selected->set_priority(selected->get_priority() + (ch == '+' ? 1 : -1));
+                    file_jobs.reschedule();
+                }
+                break;
+            }
+            case KEY_RESIZE :
+            case 'q' :
+            case 'j' : {
+                flag_continue = false;
+                break;
+            }
+            default : {
+                break;
+            }
+        }
+    }
+    timeout(-1);
+    close_overlay(win);
+}
+
+static void verify_show_content(WINDOW *_win, int _height, int _weight, size_t _start,
+                                const std::vector<std::string> &_mismatches) {
+    werase(_win);
+    box(_win, 0, 0);
+    wattron(_win, A_BOLD);
+    mvwprintw(_win, 0, (_weight - static_cast<int>(strlen(HEADER_VERIFY))) / 2, "%s", HEADER_VERIFY);
+    mvwprintw(_win, _height - 1, (_weight - static_cast<int>(strlen(VERIFY_PANEL_HINT))) / 2, "%s", VERIFY_PANEL_HINT);
+    int rows = _height - 2;
+    for (size_t i = _start; i < _mismatches.size() && i < _start + rows; i++) {
+        mvwprintw(_win, static_cast<int>(1 + i - _start), 2, "%.*s", _weight - 4, _mismatches[i].c_str());
+    }
+    wattroff(_win, A_BOLD);
+    wrefresh(_win);
+}
+
+void create_verify_panel(const std::vector<std::string> &_mismatches) {
+    int height = VERIFY_PANEL_HEIGHT;
+    int weight = COLS - 6 < PROGRESS_PANEL_WIDTH ? COLS - 6 : PROGRESS_PANEL_WIDTH;
+    WINDOW *win = newwin(height, weight, (LINES - height) / 2, (COLS - weight) / 2);
+    wbkgd(win, COLOR_PAIR(6));
+    size_t rows = static_cast<size_t>(height - 2);
+    size_t last_start = _mismatches.size() > rows ? _mismatches.size() - rows : 0;
+    size_t start = 0;
+    bool flag_continue = true;
+    while (flag_continue) {
+        verify_show_content(win, height, weight, start, _mismatches);
+        switch (wait_key()) {
+            case KEY_UP : {
+                if (start > 0) {
+                    start--;
+                }
+                break;
+            }
+            case KEY_DOWN : {
+                if (start < last_start) {
+                    start++;
+                }
+                break;
+            }
+            case KEY_RESIZE :
+            case '\n' :
+            case 'q' : {
+                flag_continue = false;
+                break;
+            }
+            default : {
+                break;
+            }
+        }
+    }
+    close_overlay(win);
+}
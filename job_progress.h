@@ -0,0 +1,165 @@
+#ifndef COURSE_PROJECT_JOB_PROGRESS_H
+#define COURSE_PROJECT_JOB_PROGRESS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <panel.h>
+#include <sys/types.h>
+#include "latency_trace.h"
+
+#define PROGRESS_REFRESH_MS 250
+#define PROGRESS_SUMMARY_MS 5000
+#define PROGRESS_MAX_JOBS 3
+#define PROGRESS_PANEL_WIDTH 72
+#define PROGRESS_RATE_SMOOTHING 0.3
+#define HEADER_PROGRESS " Jobs "
+#define JOBS_PANEL_HEIGHT 14
+#define JOBS_PANEL_HINT "Pause[p] Cancel[c] Priority[+/-] Close[j]"
+#define HEADER_VERIFY " Verify mismatches "
+#define VERIFY_PANEL_HEIGHT 16
+#define VERIFY_PANEL_HINT "Close[q]"
+
+enum class JOB_KIND : unsigned char {
+    COPY = 0,
+    MOVE = 1,
+    DELETE = 2,
+    CHMOD = 3,
+};
+
+enum class JOB_STATE : unsigned char {
+    QUEUED = 0,
+    RUNNING = 1,
+    PAUSED = 2,
+    CANCELLED = 3,
+    DONE = 4,
+};
+
+// Counters and controls of one copy, move, delete or chmod. The worker adds
+// to the done side and calls checkpoint() between entries, a scanner thread
+// started with the job fills in the totals, and the UI thread samples both to
+// derive the current rates and flips the pause and cancel flags.
+// Copies count files and bytes, and separately the bytes actually written,
+// which a sparse copy keeps below the logical size; the other kinds count every entry they
+// rename, remove or change, directories included, and no bytes. A verified
+// copy also counts the files its verifier confirmed and keeps the ones that
+// did not match, with the reason.
+class job_progress {
+public:
+    using descend_function = std::function<bool(const std::filesystem::directory_entry&)>;
+private:
+    JOB_KIND kind;
+    std::string name;
+    std::filesystem::path root;
+    descend_function descend;
+    std::vector<dev_t> devices;
+    std::atomic<int> priority;
+    std::atomic<int64_t> start_ns;
+    std::atomic<uint64_t> total_files;
+    std::atomic<uint64_t> total_bytes;
+    std::atomic<bool> scanned;
+    std::atomic<uint64_t> done_files;
+    std::atomic<uint64_t> done_bytes;
+    std::atomic<uint64_t> written_bytes;
+    std::atomic<bool> paused;
+    std::atomic<bool> cancelled;
+    std::atomic<bool> finished;
+    std::atomic<uint64_t> finish_ns;
+    std::atomic<bool> verify;
+    std::atomic<uint64_t> verified_files;
+    mutable std::mutex mismatch_mutex;
+    std::vector<std::string> mismatches;
+    std::mutex pause_mutex;
+    std::condition_variable pause_wake;
+    std::thread scanner;
+    bool sampled;
+    trace_clock::time_point sample_time;
+    uint64_t sample_files;
+    uint64_t sample_bytes;
+    double files_rate;
+    double bytes_rate;
+    void scan();
+    [[nodiscard]] double fraction() const;
+    [[nodiscard]] std::string verify_note() const;
+public:
+    job_progress(JOB_KIND _kind, std::string _name, std::filesystem::path _root, descend_function _descend,
+                 std::vector<dev_t> _devices);
+    ~job_progress();
+    job_progress(const job_progress&) = delete;
+    job_progress& operator=(const job_progress&) = delete;
+    void start();
+    void add_files(uint64_t _files);
+    void add_bytes(uint64_t _bytes);
+    void add_written(uint64_t _bytes);
+    [[nodiscard]] std::atomic<uint64_t>* get_byte_counter();
+    void enable_verify();
+    void add_verified(uint64_t _files);
+    void add_mismatch(const std::string& _mismatch);
+    [[nodiscard]] bool is_verifying() const;
+    [[nodiscard]] std::vector<std::string> get_mismatches() const;
+    bool checkpoint();
+    void pause();
+    void resume();
+    void cancel();
+    void finish();
+    void sample(trace_clock::time_point _now);
+    void set_priority(int _priority);
+    [[nodiscard]] int get_priority() const;
+    [[nodiscard]] const std::vector<dev_t>& get_devices() const;
+    [[nodiscard]] JOB_KIND get_kind() const;
+    [[nodiscard]] JOB_STATE get_state() const;
+    [[nodiscard]] bool is_paused() const;
+    [[nodiscard]] bool is_cancelled() const;
+    [[nodiscard]] uint64_t get_done_files() const;
+    [[nodiscard]] uint64_t get_done_bytes() const;
+    [[nodiscard]] uint64_t get_elapsed_ns() const;
+    [[nodiscard]] std::string progress_line(size_t _bar_width) const;
+    [[nodiscard]] std::string rate_line() const;
+    [[nodiscard]] std::string status_line() const;
+    [[nodiscard]] std::string summary() const;
+};
+
+// UI-thread list of submitted jobs and the panel that shows them. The panel is
+// redrawn every PROGRESS_REFRESH_MS while a job is queued or running, whatever
+// the job does, and keeps the last summary for PROGRESS_SUMMARY_MS after the
+// last one ends.
+class progress_board {
+private:
+    std::vector<std::shared_ptr<job_progress>> jobs;
+    std::string last_summary;
+    trace_clock::time_point summary_until;
+    trace_clock::time_point next_draw;
+    WINDOW* win;
+    PANEL* panel;
+    int drawn_y;
+    int drawn_height;
+    int drawn_width;
+    void close_panel();
+public:
+    progress_board();
+    std::shared_ptr<job_progress> begin(JOB_KIND _kind, const std::string& _name, const std::filesystem::path& _root,
+                                        const std::vector<std::filesystem::path>& _touched,
+                                        job_progress::descend_function _descend = nullptr);
+    void end(const std::shared_ptr<job_progress>& _job);
+    [[nodiscard]] const std::vector<std::shared_ptr<job_progress>>& get_jobs() const;
+    [[nodiscard]] int wait_ms() const;
+    bool tick();
+    void close();
+};
+
+const char* job_kind_label(JOB_KIND _kind);
+const char* job_state_label(JOB_STATE _state);
+std::string format_bytes(double _bytes);
+void create_jobs_panel();
+void create_verify_panel(const std::vector<std::string>& _mismatches);
+
+extern progress_board job_board;
+
+#endif //COURSE_PROJECT_JOB_PROGRESS_H
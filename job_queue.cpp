@@ -0,0 +1,124 @@
+#include <algorithm>
+#include "job_queue.h"
+#include "task_runner.h"
+
+job_queue file_jobs;
+
+job_queue::job_queue() {
+    this->next_order = 0;
+    this->stopping = false;
+}
+
+void job_queue::submit(std::shared_ptr<job_progress> _job, std::function<void()> _work,
+                       std::function<void()> _done) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.push_back({std::move(_job), std::move(_work), std::move(_done), next_order++});
+    schedule();
+}
+
+void job_queue::reschedule() {
+    std::lock_guard<std::mutex> lock(mutex);
+    schedule();
+}
+
+void job_queue::cancel_all() {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+    for (auto &&entry: pending) {
+        entry.job->cancel();
+    }
+    for (auto &&job: running) {
+        job->cancel();
+    }
+    pending.clear();
+}
+
+// Jobs left waiting on a prompt only give up once background has stopped,
+// so this runs after background.shutdown().
+void job_queue::join_all() {
+    std::vector<std::thread> remaining;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        remaining.swap(threads);
+        exited.clear();
+    }
+    for (auto &&thread: remaining) {
+        thread.join();
+    }
+}
+
+// Called with the mutex held. A thread only reports itself as exited after
+// its last use of the mutex, so joining it here does not wait for long.
+void job_queue::reap() {
+    for (auto &&id: exited) {
+        auto thread = std::find_if(threads.begin(), threads.end(), [id](const std::thread &_thread) {
+            return _thread.get_id() == id;
+        });
+        if (thread != threads.end()) {
+            thread->join();
+            threads.erase(thread);
+        }
+    }
+    exited.clear();
+}
+
+// Called with the mutex held.
+void job_queue::schedule() {
+    reap();
+    std::stable_sort(pending.begin(), pending.end(), [](const queued_job &_first, const queued_job &_second) {
+        int first_priority = _first.job->get_priority();
+        int second_priority = _second.job->get_priority();
+        return first_priority != second_priority ? first_priority > second_priority : _first.order < _second.order;
+    });
+    for (auto it = pending.begin(); it != pending.end();) {
+        job_progress &job = *it->job;
+        if (job.is_cancelled()) {
+            complete(*it);
+            it = pending.erase(it);
+            continue;
+        }
+        const std::vector<dev_t> &devices = job.get_devices();
+        bool busy = std::any_of(devices.begin(), devices.end(), [this](dev_t _device) {
+            return std::find(busy_devices.begin(), busy_devices.end(), _device) != busy_devices.end();
+        });
+        if (stopping || busy || job.is_paused()) {
+            ++it;
+            continue;
+        }
+        busy_devices.insert(busy_devices.end(), devices.begin(), devices.end());
+        running.push_back(it->job);
+        queued_job entry = std::move(*it);
+        it = pending.erase(it);
+        threads.emplace_back([this, entry]() {
+            run(entry);
+        });
+    }
+}
+
+void job_queue::run(const queued_job &_entry) {
+    _entry.job->start();
+    if (_entry.job->checkpoint()) {
+        _entry.work();
+    }
+    complete(_entry);
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto &&device: _entry.job->get_devices()) {
+        auto busy = std::find(busy_devices.begin(), busy_devices.end(), device);
+        if (busy != busy_devices.end()) {
+            busy_devices.erase(busy);
+        }
+    }
+    running.erase(std::remove(running.begin(), running.end(), _entry.job), running.end());
+    schedule();
+    exited.push_back(std::this_thread::get_id());
+}
+
+void job_queue::complete(const queued_job &_entry) {
+    _entry.job->finish();
+    std::shared_ptr<job_progress> job = _entry.job;
+    std::function<void()> done = _entry.done;
+    background.post([job, done]() {
+        job_board.end(job);
+        done();
+    });
+}
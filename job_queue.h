@@ -0,0 +1,50 @@
+#ifndef COURSE_PROJECT_JOB_QUEUE_H
+#define COURSE_PROJECT_JOB_QUEUE_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <sys/types.h>
+#include "job_progress.h"
+
+// Runs file jobs one per device at a time: a job starts once none of the
+// devices it reads or writes is busy, so jobs on one disk run one after
+// another and jobs on different disks overlap. Among the jobs that could
+// start, higher priority goes first, then the older one. Paused jobs that
+// have not started keep their place without blocking others. Each started
+// job gets a thread of its own rather than a background worker, since it may
+// sit paused or on a prompt for as long as the user likes.
+class job_queue {
+private:
+    struct queued_job {
+        std::shared_ptr<job_progress> job;
+        std::function<void()> work;
+        std::function<void()> done;
+        uint64_t order;
+    };
+    std::mutex mutex;
+    std::vector<queued_job> pending;
+    std::vector<std::shared_ptr<job_progress>> running;
+    std::vector<dev_t> busy_devices;
+    std::vector<std::thread> threads;
+    std::vector<std::thread::id> exited;
+    uint64_t next_order;
+    bool stopping;
+    void schedule();
+    void reap();
+    void run(const queued_job& _entry);
+    static void complete(const queued_job& _entry);
+public:
+    job_queue();
+    void submit(std::shared_ptr<job_progress> _job, std::function<void()> _work, std::function<void()> _done);
+    void reschedule();
+    void cancel_all();
+    void join_all();
+};
+
+extern job_queue file_jobs;
+
+#endif //COURSE_PROJECT_JOB_QUEUE_H
@@ -0,0 +1,192 @@
+#include <cstdio>
+#include <cstdlib>
+#include <curses.h>
+#include <filesystem>
+#include <fcntl.h>
+#include <unistd.h>
+#include "latency_trace.h"
+
+latency_tracer ui_tracer;
+
+uint64_t elapsed_ns(trace_clock::time_point _from, trace_clock::time_point _to) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(_to - _from).count());
+}
+
+static size_t histogram_bucket(uint64_t _ns) {
+    uint64_t us = _ns / 1000;
+    size_t bucket = 0;
+    while (us > 0 && bucket + 1 < TRACE_HISTOGRAM_BUCKETS) {
+        us >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+const char *span_kind_label(SPAN_KIND _kind) {
+    switch (_kind) {
+        case SPAN_KIND::LISTING :
+            return "list";
+        case SPAN_KIND::SORT :
+            return "sort";
+        case SPAN_KIND::RENDER :
+            return "render";
+        case SPAN_KIND::FIND :
+            return "find";
+        case SPAN_KIND::SIZE :
+            return "size";
+        case SPAN_KIND::FILE_OP :
+            return "op";
+        case SPAN_KIND::INFO :
+            return "info";
+        default :
+            return "?";
+    }
+}
+
+int wait_key() {
+    auto start = trace_clock::now();
+    int ch = getch();
+    ui_tracer.add_idle(elapsed_ns(start, trace_clock::now()));
+    return ch;
+}
+
+latency_tracer::latency_tracer() : recent(), stats() {
+    this->origin = trace_clock::now();
+    this->recent_count = 0;
+    this->idle_ns = 0;
+    this->overlay = false;
+    this->used = getenv(TRACE_FILE_ENV) != nullptr;
+}
+
+void latency_tracer::record(SPAN_KIND _kind, trace_clock::time_point _start, uint64_t _duration_ns) {
+    span_stats &entry = stats[static_cast<size_t>(_kind)];
+    entry.count++;
+    entry.total_ns += _duration_ns;
+    entry.last_ns = _duration_ns;
+    if (_duration_ns > entry.max_ns) {
+        entry.max_ns = _duration_ns;
+    }
+    entry.histogram[histogram_bucket(_duration_ns)]++;
+    recent[recent_count % TRACE_RING_SIZE] = {_kind, elapsed_ns(origin, _start), _duration_ns};
+    recent_count++;
+}
+
+void latency_tracer::add_idle(uint64_t _ns) {
+    idle_ns += _ns;
+}
+
+uint64_t latency_tracer::get_idle() const {
+    return idle_ns;
+}
+
+void latency_tracer::toggle_overlay() {
+    overlay = !overlay;
+    used = true;
+}
+
+bool latency_tracer::overlay_visible() const {
+    return overlay;
+}
+
+std::string latency_tracer::summary() const {
+    std::string result;
+    char buffer[48];
+    for (size_t kind = 0; kind < stats.size(); kind++) {
+        if (stats[kind].count == 0) {
+            snprintf(buffer, sizeof(buffer), "%s -  ", span_kind_label(static_cast<SPAN_KIND>(kind)));
+        } else {
+            snprintf(buffer, sizeof(buffer), "%s %.2f  ", span_kind_label(static_cast<SPAN_KIND>(kind)),
+                     static_cast<double>(stats[kind].last_ns) / 1e6);
+        }
+        result += buffer;
+    }
+    return result + "(ms)";
+}
+
+void latency_tracer::add_report_section(const std::string &_name, const std::string &_json) {
+    sections.emplace_back(_name, _json);
+}
+
+bool latency_tracer::write_report() const {
+    if (!used) {
+        return false;
+    }
+    // The default stays out of shared directories such as /tmp, and the file
+    // is never opened through a symlink, so another user cannot plant one
+    // that redirects the report onto a file of ours.
+    // Without XDG_STATE_HOME the XDG default under $HOME applies; only with
+    // neither set does the report land in the current directory.
+    std::string path;
+    if (const char *env = getenv(TRACE_FILE_ENV)) {
+        path = env;
+    } else {
+        std::filesystem::path state_dir;
+        const char *home = getenv("HOME");
+        if (const char *state = getenv("XDG_STATE_HOME"); state != nullptr && state[0] == '/') {
+            state_dir = state;
+        } else if (home != nullptr && home[0] == '/') {
+            state_dir = std::filesystem::path(home) / ".local" / "state";
+        }
+        if (state_dir.empty()) {
+            path = TRACE_FILE_NAME;
+        } else {
+            std::error_code error;
+            std::filesystem::create_directories(state_dir, error);
+            path = (state_dir / TRACE_FILE_NAME).string();
+        }
+    }
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_NOFOLLOW | O_CLOEXEC, 0600);
+    if (fd == -1) {
+        return false;
+    }
+    FILE *out = fdopen(fd, "w");
+    if (out == nullptr) {
+        close(fd);
+        return false;
+    }
+    fprintf(out, "{\n  \"spans\": {");
+    for (size_t kind = 0; kind < stats.size(); kind++) {
+        const span_stats &entry = stats[kind];
+        fprintf(out, "%s\n    \"%s\": {\"count\": %llu, \"total_ms\": %.3f, \"max_ms\": %.3f, \"histogram_us\": {",
+                kind == 0 ? "" : ",", span_kind_label(static_cast<SPAN_KIND>(kind)),
+                static_cast<unsigned long long>(entry.count), static_cast<double>(entry.total_ns) / 1e6,
+                static_cast<double>(entry.max_ns) / 1e6);
+        bool first = true;
+        for (size_t bucket = 0; bucket < entry.histogram.size(); bucket++) {
+            if (entry.histogram[bucket] == 0) {
+                continue;
+            }
+            fprintf(out, "%s\"<%llu\": %llu", first ? "" : ", ", 1ULL << bucket,
+                    static_cast<unsigned long long>(entry.histogram[bucket]));
+            first = false;
+        }
+        fprintf(out, "}}");
+    }
+    fprintf(out, "\n  },\n  \"recent\": [");
+    size_t count = recent_count < TRACE_RING_SIZE ? recent_count : TRACE_RING_SIZE;
+    for (size_t i = 0; i < count; i++) {
+        const span_record &span = recent[(recent_count - count + i) % TRACE_RING_SIZE];
+        fprintf(out, "%s\n    {\"kind\": \"%s\", \"start_ms\": %.3f, \"duration_ms\": %.3f}",
+                i == 0 ? "" : ",", span_kind_label(span.kind),
+                static_cast<double>(span.start_ns) / 1e6, static_cast<double>(span.duration_ns) / 1e6);
+    }
+    fprintf(out, "\n  ]");
+    for (auto &&section: sections) {
+        fprintf(out, ",\n  \"%s\": %s", section.first.c_str(), section.second.c_str());
+    }
+    fprintf(out, "\n}\n");
+    fclose(out);
+    return true;
+}
+
+scoped_span::scoped_span(SPAN_KIND _kind) {
+    this->kind = _kind;
+    this->start = trace_clock::now();
+    this->idle_start = ui_tracer.get_idle();
+}
+
+scoped_span::~scoped_span() {
+    uint64_t total = elapsed_ns(start, trace_clock::now());
+    uint64_t idle = ui_tracer.get_idle() - idle_start;
+    ui_tracer.record(kind, start, idle < total ? total - idle : 0);
+}
@@ -0,0 +1,81 @@
+#ifndef COURSE_PROJECT_LATENCY_TRACE_H
+#define COURSE_PROJECT_LATENCY_TRACE_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define TRACE_RING_SIZE 512
+#define TRACE_HISTOGRAM_BUCKETS 32
+#define TRACE_FILE_ENV "FM_TRACE_FILE"
+#define TRACE_FILE_NAME "fm_trace.json"
+
+enum class SPAN_KIND : unsigned char {
+    LISTING = 0,
+    SORT = 1,
+    RENDER = 2,
+    FIND = 3,
+    SIZE = 4,
+    FILE_OP = 5,
+    INFO = 6,
+    COUNT = 7,
+};
+
+using trace_clock = std::chrono::steady_clock;
+
+class latency_tracer {
+private:
+    struct span_record {
+        SPAN_KIND kind;
+        uint64_t start_ns;
+        uint64_t duration_ns;
+    };
+    struct span_stats {
+        uint64_t count;
+        uint64_t total_ns;
+        uint64_t max_ns;
+        uint64_t last_ns;
+        std::array<uint64_t, TRACE_HISTOGRAM_BUCKETS> histogram;
+    };
+    trace_clock::time_point origin;
+    std::array<span_record, TRACE_RING_SIZE> recent;
+    size_t recent_count;
+    std::array<span_stats, static_cast<size_t>(SPAN_KIND::COUNT)> stats;
+    uint64_t idle_ns;
+    std::vector<std::pair<std::string, std::string>> sections;
+    bool overlay;
+    bool used;
+public:
+    latency_tracer();
+    void record(SPAN_KIND _kind, trace_clock::time_point _start, uint64_t _duration_ns);
+    void add_idle(uint64_t _ns);
+    [[nodiscard]] uint64_t get_idle() const;
+    void toggle_overlay();
+    [[nodiscard]] bool overlay_visible() const;
+    [[nodiscard]] std::string summary() const;
+    void add_report_section(const std::string& _name, const std::string& _json);
+    bool write_report() const;
+};
+
+class scoped_span {
+private:
+    SPAN_KIND kind;
+    trace_clock::time_point start;
+    uint64_t idle_start;
+public:
+    explicit scoped_span(SPAN_KIND _kind);
+    ~scoped_span();
+    scoped_span(const scoped_span&) = delete;
+    scoped_span& operator=(const scoped_span&) = delete;
+};
+
+const char* span_kind_label(SPAN_KIND _kind);
+uint64_t elapsed_ns(trace_clock::time_point _from, trace_clock::time_point _to);
+int wait_key();
+
+extern latency_tracer ui_tracer;
+
+#endif //COURSE_PROJECT_LATENCY_TRACE_H
@@ -0,0 +1,73 @@
+#include "listing_cache.h"
+
+listing_cache directory_cache(LISTING_CACHE_BUDGET);
+
+static bool same_time(const timespec &_first, const timespec &_second) {
+    return _first.tv_sec == _second.tv_sec && _first.tv_nsec == _second.tv_nsec;
+}
+
+bool directory_key::operator==(const directory_key &_other) const {
+    return dev == _other.dev && ino == _other.ino;
+}
+
+size_t directory_key_hash::operator()(const directory_key &_key) const {
+    return std::hash<dev_t>()(_key.dev) * 31 + std::hash<ino_t>()(_key.ino);
+}
+
+listing_cache::listing_cache(size_t _budget) {
+    this->budget = _budget;
+    this->used = 0;
+}
+
+void listing_cache::evict(std::list<cached_listing>::iterator _it) {
+    used -= _it->bytes;
+    index.erase(_it->key);
+    lru.erase(_it);
+}
+
+bool listing_cache::lookup(const struct stat &_st, listing &_content,
+                           size_t &_current_ind, size_t &_start_index) {
+    auto it = index.find({_st.st_dev, _st.st_ino});
+    if (it == index.end()) {
+        return false;
+    }
+    if (!same_time(it->second->mtime, _st.st_mtim) || !same_time(it->second->ctime, _st.st_ctim)) {
+        evict(it->second);
+        return false;
+    }
+    lru.splice(lru.begin(), lru, it->second);
+    _content = lru.front().content;
+    _current_ind = lru.front().current_ind;
+    _start_index = lru.front().start_index;
+    return true;
+}
+
+void listing_cache::store(const struct stat &_st, const listing &_content,
+                          size_t _current_ind, size_t _start_index) {
+    directory_key key{_st.st_dev, _st.st_ino};
+    auto it = index.find(key);
+    if (it != index.end()) {
+        evict(it->second);
+    }
+    size_t bytes = sizeof(cached_listing) + _content.bytes();
+    if (bytes > budget) {
+        return;
+    }
+    while (used + bytes > budget && !lru.empty()) {
+        evict(std::prev(lru.end()));
+    }
+    lru.push_front({key, _st.st_mtim, _st.st_ctim, _content, _current_ind, _start_index, bytes});
+    index[key] = lru.begin();
+    used += bytes;
+}
+
+void listing_cache::forget(const struct stat &_st) {
+    auto it = index.find({_st.st_dev, _st.st_ino});
+    if (it != index.end()) {
+        evict(it->second);
+    }
+}
+
+size_t listing_cache::get_used() const {
+    return used;
+}
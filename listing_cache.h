@@ -0,0 +1,48 @@
+#ifndef COURSE_PROJECT_LISTING_CACHE_H
+#define COURSE_PROJECT_LISTING_CACHE_H
+
+#include <list>
+#include <unordered_map>
+#include <sys/stat.h>
+#include "file_panel.h"
+
+#define LISTING_CACHE_BUDGET (64 * 1024 * 1024)
+
+struct directory_key {
+    dev_t dev;
+    ino_t ino;
+    bool operator==(const directory_key& _other) const;
+};
+
+struct directory_key_hash {
+    size_t operator()(const directory_key& _key) const;
+};
+
+struct cached_listing {
+    directory_key key;
+    timespec mtime;
+    timespec ctime;
+    listing content;
+    size_t current_ind;
+    size_t start_index;
+    size_t bytes;
+};
+
+class listing_cache {
+private:
+    size_t budget;
+    size_t used;
+    std::list<cached_listing> lru;
+    std::unordered_map<directory_key, std::list<cached_listing>::iterator, directory_key_hash> index;
+    void evict(std::list<cached_listing>::iterator _it);
+public:
+    explicit listing_cache(size_t _budget);
+    bool lookup(const struct stat& _st, listing& _content, size_t& _current_ind, size_t& _start_index);
+    void store(const struct stat& _st, const listing& _content, size_t _current_ind, size_t _start_index);
+    void forget(const struct stat& _st);
+    [[nodiscard]] size_t get_used() const;
+};
+
+extern listing_cache directory_cache;
+
+#endif //COURSE_PROJECT_LISTING_CACHE_H
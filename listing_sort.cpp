@@ -0,0 +1,313 @@
+#include <cctype>
+#include <thread>
+#include "listing_sort.h"
+
+struct sort_item {
+    uint64_t key;
+    uint32_t index;
+};
+
+size_t sort_slot(sort_order _order) {
+    return static_cast<size_t>(_order.mode) * 2 + (_order.reverse ? 1 : 0);
+}
+
+const char *sort_mode_label(SORT_MODE _mode) {
+    switch (_mode) {
+        case SORT_MODE::BY_NATURAL :
+            return "natural";
+        case SORT_MODE::BY_SIZE :
+            return "size";
+        case SORT_MODE::BY_MTIME :
+            return "mtime";
+        case SORT_MODE::BY_EXTENSION :
+            return "ext";
+        default :
+            return "name";
+    }
+}
+
+SORT_MODE next_sort_mode(SORT_MODE _mode) {
+    return static_cast<SORT_MODE>((static_cast<int>(_mode) + 1) % SORT_MODE_COUNT);
+}
+
+std::string_view entry_extension(std::string_view _name) {
+    size_t pos = _name.rfind('.');
+    if (pos == std::string_view::npos || pos == 0) {
+        return {};
+    }
+    return _name.substr(pos);
+}
+
+int natural_compare(std::string_view _first, std::string_view _second) {
+    size_t i = 0;
+    size_t j = 0;
+    while (i < _first.size() && j < _second.size()) {
+        auto first_ch = static_cast<unsigned char>(_first[i]);
+        auto second_ch = static_cast<unsigned char>(_second[j]);
+        if (isdigit(first_ch) && isdigit(second_ch)) {
+            while (i < _first.size() && _first[i] == '0') {
+                i++;
+            }
+            while (j < _second.size() && _second[j] == '0') {
+                j++;
+            }
+            size_t first_end = i;
+            size_t second_end = j;
+            while (first_end < _first.size() && isdigit(static_cast<unsigned char>(_first[first_end]))) {
+                first_end++;
+            }
+            while (second_end < _second.size() && isdigit(static_cast<unsigned char>(_second[second_end]))) {
+                second_end++;
+            }
+            if (first_end - i != second_end - j) {
+                return first_end - i < second_end - j ? -1 : 1;
+            }
+            int cmp = _first.substr(i, first_end - i).compare(_second.substr(j, second_end - j));
+            if (cmp != 0) {
+                return cmp;
+            }
+            i = first_end;
+            j = second_end;
+            continue;
+        }
+        if (first_ch != second_ch) {
+            return first_ch < second_ch ? -1 : 1;
+        }
+        i++;
+        j++;
+    }
+    if (_first.size() - i != _second.size() - j) {
+        return _first.size() - i < _second.size() - j ? -1 : 1;
+    }
+    return 0;
+}
+
+static int compare_by_key(const info &_first, const info &_second, SORT_MODE _mode) {
+    switch (_mode) {
+        case SORT_MODE::BY_NATURAL : {
+            int cmp = natural_compare(_first.name_content, _second.name_content);
+            if (cmp != 0) {
+                return cmp;
+            }
+            break;
+        }
+        case SORT_MODE::BY_SIZE : {
+            if (_first.size_content != _second.size_content) {
+                return _first.size_content < _second.size_content ? -1 : 1;
+            }
+            break;
+        }
+        case SORT_MODE::BY_MTIME : {
+            if (_first.modify_time != _second.modify_time) {
+                return _first.modify_time < _second.modify_time ? -1 : 1;
+            }
+            break;
+        }
+        case SORT_MODE::BY_EXTENSION : {
+            int cmp = entry_extension(_first.name_content).compare(entry_extension(_second.name_content));
+            if (cmp != 0) {
+                return cmp;
+            }
+            break;
+        }
+        default :
+            break;
+    }
+    return _first.name_content.compare(_second.name_content);
+}
+
+static size_t sort_group(const info &_entry) {
+    if (_entry.name_content == "..") {
+        return 0;
+    }
+    return static_cast<size_t>(_entry.content_type) + 1;
+}
+
+bool entry_less(const info &_first, const info &_second, sort_order _order) {
+    size_t first_group = sort_group(_first);
+    size_t second_group = sort_group(_second);
+    if (first_group != second_group) {
+        return first_group < second_group;
+    }
+    int cmp = compare_by_key(_first, _second, _order.mode);
+    return _order.reverse ? cmp > 0 : cmp < 0;
+}
+
+static uint64_t name_prefix_key(std::string_view _name) {
+    uint64_t key = 0;
+    for (size_t i = 0; i < sizeof(key); i++) {
+        key <<= 8;
+        if (i < _name.size()) {
+            key |= static_cast<unsigned char>(_name[i]);
+        }
+    }
+    return key;
+}
+
+static uint64_t signed_key(int64_t _value) {
+    return static_cast<uint64_t>(_value) ^ (1ULL << 63);
+}
+
+static std::string_view key_text(const info &_entry, SORT_MODE _mode) {
+    return _mode == SORT_MODE::BY_EXTENSION ? entry_extension(_entry.name_content) : _entry.name_content;
+}
+
+static uint64_t sort_key(const info &_entry, SORT_MODE _mode, size_t _skip) {
+    switch (_mode) {
+        case SORT_MODE::BY_SIZE :
+            return signed_key(_entry.size_content);
+        case SORT_MODE::BY_MTIME :
+            return signed_key(_entry.modify_time);
+        default : {
+            std::string_view text = key_text(_entry, _mode);
+            return name_prefix_key(text.substr(std::min(_skip, text.size())));
+        }
+    }
+}
+
+static size_t common_prefix(const listing &_content, const uint32_t *_first, const uint32_t *_last, SORT_MODE _mode) {
+    if (_mode == SORT_MODE::BY_SIZE || _mode == SORT_MODE::BY_MTIME) {
+        return 0;
+    }
+    std::string_view prefix = key_text(_content[*_first], _mode);
+    for (const uint32_t *it = _first + 1; it != _last && !prefix.empty(); ++it) {
+        std::string_view text = key_text(_content[*it], _mode);
+        size_t len = 0;
+        while (len < prefix.size() && len < text.size() && prefix[len] == text[len]) {
+            len++;
+        }
+        prefix = prefix.substr(0, len);
+    }
+    return prefix.size();
+}
+
+static void radix_sort(std::vector<sort_item> &_items) {
+    std::vector<sort_item> buffer(_items.size());
+    for (int shift = 0; shift < 64; shift += 8) {
+        size_t count[257] = {};
+        for (auto &&item: _items) {
+            count[((item.key >> shift) & 0xFF) + 1]++;
+        }
+        if (count[((_items[0].key >> shift) & 0xFF) + 1] == _items.size()) {
+            continue;
+        }
+        for (size_t b = 0; b < 256; b++) {
+            count[b + 1] += count[b];
+        }
+        for (auto &&item: _items) {
+            buffer[count[(item.key >> shift) & 0xFF]++] = item;
+        }
+        _items.swap(buffer);
+    }
+}
+
+template<typename Compare>
+static void parallel_sort(uint32_t *_first, uint32_t *_last, Compare _comp) {
+    size_t count = _last - _first;
+    size_t workers = std::min<size_t>(std::thread::hardware_concurrency(), PARALLEL_SORT_MAX_THREADS);
+    if (count < PARALLEL_SORT_THRESHOLD || workers < 2) {
+        std::sort(_first, _last, _comp);
+        return;
+    }
+    size_t chunk = (count + workers - 1) / workers;
+    std::vector<std::thread> threads;
+    for (size_t from = 0; from < count; from += chunk) {
+        threads.emplace_back([=]() {
+            std::sort(_first + from, _first + std::min(from + chunk, count), _comp);
+        });
+    }
+    for (auto &&thread: threads) {
+        thread.join();
+    }
+    for (size_t width = chunk; width < count; width *= 2) {
+        threads.clear();
+        for (size_t from = 0; from + width < count; from += 2 * width) {
+            threads.emplace_back([=]() {
+                std::inplace_merge(_first + from, _first + from + width,
+                                   _first + std::min(from + 2 * width, count), _comp);
+            });
+        }
+        for (auto &&thread: threads) {
+            thread.join();
+        }
+    }
+}
+
+static bool ties_share_key(const listing &_content, const uint32_t *_first, const uint32_t *_last, SORT_MODE _mode) {
+    if (_mode != SORT_MODE::BY_EXTENSION) {
+        return true;
+    }
+    std::string_view extension = entry_extension(_content[*_first].name_content);
+    for (const uint32_t *it = _first + 1; it != _last; ++it) {
+        if (entry_extension(_content[*it].name_content) != extension) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void sort_range(const listing &_content, uint32_t *_first, uint32_t *_last, SORT_MODE _mode) {
+    auto less = [&_content, _mode](uint32_t _a, uint32_t _b) {
+        return compare_by_key(_content[_a], _content[_b], _mode) < 0;
+    };
+    if (_mode == SORT_MODE::BY_NATURAL) {
+        parallel_sort(_first, _last, less);
+        return;
+    }
+    size_t count = _last - _first;
+    size_t skip = common_prefix(_content, _first, _last, _mode);
+    std::vector<sort_item> items(count);
+    for (size_t i = 0; i < count; i++) {
+        items[i] = {sort_key(_content[_first[i]], _mode, skip), _first[i]};
+    }
+    if (count >= RADIX_SORT_THRESHOLD) {
+        radix_sort(items);
+    } else {
+        std::sort(items.begin(), items.end(),
+                  [](const sort_item &_a, const sort_item &_b) { return _a.key < _b.key; });
+    }
+    for (size_t i = 0; i < count; i++) {
+        _first[i] = items[i].index;
+    }
+    for (size_t run = 0; run < count;) {
+        size_t end = run + 1;
+        while (end < count && items[end].key == items[run].key) {
+            end++;
+        }
+        if (end - run >= RADIX_SORT_THRESHOLD && ties_share_key(_content, _first + run, _first + end, _mode)) {
+            sort_range(_content, _first + run, _first + end, SORT_MODE::BY_NAME);
+        } else if (end - run > 1) {
+            parallel_sort(_first + run, _first + end, less);
+        }
+        run = end;
+    }
+}
+
+std::vector<uint32_t> sort_permutation(const listing &_content, sort_order _order) {
+    size_t count = _content.size();
+    std::vector<uint32_t> order(count);
+    std::vector<unsigned char> groups(count);
+    size_t bounds[SORT_GROUP_COUNT + 1] = {};
+    for (size_t i = 0; i < count; i++) {
+        groups[i] = static_cast<unsigned char>(sort_group(_content[i]));
+        bounds[groups[i] + 1]++;
+    }
+    for (size_t g = 0; g < SORT_GROUP_COUNT; g++) {
+        bounds[g + 1] += bounds[g];
+    }
+    size_t fill[SORT_GROUP_COUNT];
+    std::copy(bounds, bounds + SORT_GROUP_COUNT, fill);
+    for (size_t i = 0; i < count; i++) {
+        order[fill[groups[i]]++] = static_cast<uint32_t>(i);
+    }
+    for (size_t g = 1; g < SORT_GROUP_COUNT; g++) {
+        if (bounds[g + 1] - bounds[g] < 2) {
+            continue;
+        }
+        sort_range(_content, order.data() + bounds[g], order.data() + bounds[g + 1], _order.mode);
+        if (_order.reverse) {
+            std::reverse(order.begin() + static_cast<long>(bounds[g]), order.begin() + static_cast<long>(bounds[g + 1]));
+        }
+    }
+    return order;
+}
@@ -0,0 +1,20 @@
+#ifndef COURSE_PROJECT_LISTING_SORT_H
+#define COURSE_PROJECT_LISTING_SORT_H
+
+#include <string_view>
+#include <vector>
+#include "file_panel.h"
+
+#define RADIX_SORT_THRESHOLD 2048
+#define PARALLEL_SORT_THRESHOLD 65536
+#define PARALLEL_SORT_MAX_THREADS 8
+
+size_t sort_slot(sort_order _order);
+const char* sort_mode_label(SORT_MODE _mode);
+SORT_MODE next_sort_mode(SORT_MODE _mode);
+std::string_view entry_extension(std::string_view _name);
+int natural_compare(std::string_view _first, std::string_view _second);
+bool entry_less(const info& _first, const info& _second, sort_order _order);
+std::vector<uint32_t> sort_permutation(const listing& _content, sort_order _order);
+
+#endif //COURSE_PROJECT_LISTING_SORT_H
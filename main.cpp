@@ -1,8 +1,47 @@
 #include <iostream>
+#include <cerrno>
+#include <chrono>
 #include "file_panel.h"
+#include "listing_sort.h"
+#include "colorizer.h"
+#include "latency_trace.h"
+#include "task_runner.h"
+#include "copy_engine.h"
+#include "uring_copy.h"
+#include "job_progress.h"
+#include "job_queue.h"
+
+static int next_key(WINDOW *_input) {
+    nodelay(_input, true);
+    int ch = wgetch(_input);
+    nodelay(_input, false);
+    return ch;
+}
+
+static bool is_navigation_key(int _ch) {
+    return _ch == KEY_UP || _ch == KEY_DOWN || _ch == KEY_PPAGE || _ch == KEY_NPAGE
+           || _ch == KEY_HOME || _ch == KEY_END;
+}
+
+static int frame_wait_ms(bool _render_pending, std::chrono::steady_clock::time_point _last_frame) {
+    if (!_render_pending) {
+        return -1;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - _last_frame).count();
+    return elapsed >= FRAME_BUDGET_MS ? 0 : static_cast<int>(FRAME_BUDGET_MS - elapsed);
+}
+
+static int earliest_wait_ms(int _first, int _second) {
+    if (_first < 0) {
+        return _second;
+    }
+    return _second < 0 || _first < _second ? _first : _second;
+}
 
 int main() {
     setlocale(LC_ALL, "");
+    entry_colorizer.load_environment();
     initscr();
     noecho();
     cbreak();
@@ -11,7 +50,11 @@ int main() {
     keypad(stdscr, true);
     curs_set(0);
 
-    bool flag_is_resize = false;
+    // Keys are read through a window that is never drawn, so wgetch does not
+    // flush the staged status line (stdscr) in the middle of an input batch.
+    WINDOW *input_win = newwin(1, 1, LINES - 1, COLS - 1);
+    keypad(input_win, true);
+    wnoutrefresh(input_win);
 
 
    /* file_panel left_panel("/home/limbo/COURSE_PROJECT/cmake-build-debug",
@@ -29,143 +72,231 @@ int main() {
 
     left_panel.display_content();
     right_panel.display_content();
+    flush_frame();
 
     int ch;
+    bool running = true;
+    bool render_pending = false;
+    auto last_frame = std::chrono::steady_clock::now();
 
-    while ((ch = getch()) != KEY_F(1)) {
-        switch (ch) {
-            case KEY_UP : {
-                current_panel->move_cursor_and_pagination(KEY_UP);
-                break;
-            }
-            case KEY_DOWN : {
-                current_panel->move_cursor_and_pagination(KEY_DOWN);
-                break;
-            }
-            case '\n' : {
-                current_panel->switch_directory(current_panel
-                                                        ->get_content()[current_panel->get_current_ind()]
-                                                        .name_content);
-                break;
-            }
-            case KEY_RESIZE : {
-                flag_is_resize = true;
-                clear();
-                refresh();
-                left_panel.resize_panel(LINES - 1, COLS / 2, 0, 0);
-                right_panel.resize_panel(LINES - 1, COLS / 2, 0, COLS / 2);
-                left_panel.display_content();
-                right_panel.display_content();
-                break;
-            }
-            case KEY_F(2) : {
-                current_panel == &left_panel
-                ? current_panel->delete_content(right_panel)
-                : current_panel->delete_content(left_panel);
-                break;
-            }
-            case KEY_F(3) : {
-                current_panel == &left_panel
-                ? current_panel->create_symlink(right_panel)
-                : current_panel->create_symlink(left_panel);
-                break;
-            }
-            case KEY_F(5) : {
-                current_panel == &left_panel
-                ? current_panel->create_directory(right_panel)
-                : current_panel->create_directory(left_panel);
-                break;
-            }
-            case KEY_F(6) : {
-                current_panel == &left_panel
-                ? current_panel->create_file(right_panel)
-                : current_panel->create_file(left_panel);
-                break;
-            }
-            case KEY_F(7) : {
-                current_panel == &left_panel
-                ? current_panel->rename_content(right_panel)
-                : current_panel->rename_content(left_panel);
-                break;
-            }
-            case KEY_F(8) : {
-                current_panel == &left_panel
-                ? current_panel->copy_content(right_panel)
-                : current_panel->copy_content(left_panel);
-                break;
-            }
-            case KEY_F(9) : {
-                current_panel == &left_panel
-                ? current_panel->move_content(right_panel)
-                : current_panel->move_content(left_panel);
-                break;
-            }
-            case 'p' : {
-                current_panel == &left_panel
-                ? current_panel->edit_permissions(right_panel)
-                : current_panel->edit_permissions(left_panel);
-                break;
-            }
-            case 'i' : {
-                current_panel->analysis_selected_file();
-                break;
-            }
-            case 'o' : {
-                find_utility(left_panel, right_panel, current_panel->get_current_directory());
+    while (running) {
+        std::vector<pollfd> fds{{STDIN_FILENO, POLLIN, 0}, {background.get_event_fd(), POLLIN, 0}};
+        left_panel.collect_poll_fds(fds);
+        right_panel.collect_poll_fds(fds);
+        int wait_ms = earliest_wait_ms(frame_wait_ms(render_pending, last_frame), job_board.wait_ms());
+        if (poll(fds.data(), fds.size(), wait_ms) == -1 && errno != EINTR) {
+            break;
+        }
+        if (background.run_completions()) {
+            render_pending = true;
+        }
+        if (job_board.tick()) {
+            render_pending = true;
+        }
+        if (left_panel.process_events()) {
+            render_pending = true;
+        }
+        if (right_panel.process_events()) {
+            render_pending = true;
+        }
+        while ((ch = next_key(input_win)) != ERR) {
+            if (ch == KEY_F(1)) {
+                running = false;
                 break;
             }
-            case 'f' : {
-                filesystem_info_mount();
-                break;
+            if (current_panel->is_quick_searching() && current_panel->quick_search_key(ch)) {
+                render_pending = true;
+                continue;
             }
-            case 'v' : {
-                current_panel->calculate_size();
-                break;
+            if (!is_navigation_key(ch) && render_pending) {
+                left_panel.render();
+                right_panel.render();
             }
-            case 'h' : {
-                std::string return_result;
-                create_history_panel(return_result);
-                std::filesystem::path p(return_result);
-                if (std::filesystem::exists(p)) {
-                    if ((status(p).permissions() & std::filesystem::perms::owner_read) == std::filesystem::perms::none
-                    || (status(p).permissions() & std::filesystem::perms::owner_exec) == std::filesystem::perms::none) {
-                        left_panel.display_content();
-                        right_panel.display_content();
-                        std::string message = "Cannot open directory: '" + p.filename().string() + "'";
-                        create_error_panel(" Permission error ", message, HEIGHT_FUNCTIONAL_PANEL,
-                                           WEIGHT_FUNCTIONAL_PANEL > message.length()
-                                           ? WEIGHT_FUNCTIONAL_PANEL : message.length());
-                        break;
+            render_pending = true;
+            switch (ch) {
+                case KEY_UP : {
+                    current_panel->move_cursor_and_pagination(KEY_UP);
+                    break;
+                }
+                case KEY_DOWN : {
+                    current_panel->move_cursor_and_pagination(KEY_DOWN);
+                    break;
+                }
+                case KEY_PPAGE :
+                case KEY_NPAGE :
+                case KEY_HOME :
+                case KEY_END : {
+                    current_panel->move_cursor_and_pagination(ch);
+                    break;
+                }
+                case 'g' : {
+                    current_panel->go_to_entry();
+                    break;
+                }
+                case '/' : {
+                    current_panel->start_quick_search();
+                    break;
+                }
+                case 'l' : {
+                    ui_tracer.toggle_overlay();
+                    break;
+                }
+                case '\n' : {
+                    current_panel->switch_directory(std::string(current_panel
+                                                                        ->get_content()[current_panel->get_current_ind()]
+                                                                        .name_content));
+                    break;
+                }
+                case KEY_RESIZE : {
+                    clear();
+                    left_panel.resize_panel(LINES - 1, COLS / 2, 0, 0);
+                    right_panel.resize_panel(LINES - 1, COLS / 2, 0, COLS / 2);
+                    left_panel.display_content();
+                    right_panel.display_content();
+                    break;
+                }
+                case KEY_F(2) : {
+                    current_panel == &left_panel
+                    ? current_panel->delete_content(right_panel)
+                    : current_panel->delete_content(left_panel);
+                    break;
+                }
+                case KEY_F(3) : {
+                    current_panel == &left_panel
+                    ? current_panel->create_symlink(right_panel)
+                    : current_panel->create_symlink(left_panel);
+                    break;
+                }
+                case KEY_F(5) : {
+                    current_panel == &left_panel
+                    ? current_panel->create_directory(right_panel)
+                    : current_panel->create_directory(left_panel);
+                    break;
+                }
+                case KEY_F(6) : {
+                    current_panel == &left_panel
+                    ? current_panel->create_file(right_panel)
+                    : current_panel->create_file(left_panel);
+                    break;
+                }
+                case KEY_F(7) : {
+                    current_panel == &left_panel
+                    ? current_panel->rename_content(right_panel)
+                    : current_panel->rename_content(left_panel);
+                    break;
+                }
+                case KEY_F(8) : {
+                    current_panel == &left_panel
+                    ? current_panel->copy_content(right_panel)
+                    : current_panel->copy_content(left_panel);
+                    break;
+                }
+                case KEY_F(9) : {
+                    current_panel == &left_panel
+                    ? current_panel->move_content(right_panel)
+                    : current_panel->move_content(left_panel);
+                    break;
+                }
+                case 'p' : {
+                    current_panel == &left_panel
+                    ? current_panel->edit_permissions(right_panel)
+                    : current_panel->edit_permissions(left_panel);
+                    break;
+                }
+                case 'i' : {
+                    current_panel->analysis_selected_file();
+                    break;
+                }
+                case 'o' : {
+                    find_utility(left_panel, right_panel, current_panel->get_current_directory());
+                    break;
+                }
+                case 'f' : {
+                    filesystem_info_mount();
+                    break;
+                }
+                case 'v' : {
+                    current_panel->calculate_size();
+                    break;
+                }
+                case 's' : {
+                    sort_order order = current_panel->get_sort_order();
+                    order.mode = next_sort_mode(order.mode);
+                    current_panel->set_sort_order(order);
+                    break;
+                }
+                case 'j' : {
+                    create_jobs_panel();
+                    break;
+                }
+                case 'u' : {
+                    current_panel->set_copy_backend(next_copy_backend(current_panel->get_copy_backend()));
+                    break;
+                }
+                case 'c' : {
+                    current_panel->set_verify_copies(!current_panel->get_verify_copies());
+                    break;
+                }
+                case 'r' : {
+                    sort_order order = current_panel->get_sort_order();
+                    order.reverse = !order.reverse;
+                    current_panel->set_sort_order(order);
+                    break;
+                }
+                case 'h' : {
+                    std::string return_result;
+                    create_history_panel(return_result);
+                    std::filesystem::path p(return_result);
+                    if (std::filesystem::exists(p)) {
+                        if ((status(p).permissions() & std::filesystem::perms::owner_read) == std::filesystem::perms::none
+                        || (status(p).permissions() & std::filesystem::perms::owner_exec) == std::filesystem::perms::none) {
+                            left_panel.display_content();
+                            right_panel.display_content();
+                            std::string message = "Cannot open directory: '" + p.filename().string() + "'";
+                            create_error_panel(" Permission error ", message, HEIGHT_FUNCTIONAL_PANEL,
+                                               WEIGHT_FUNCTIONAL_PANEL > message.length()
+                                               ? WEIGHT_FUNCTIONAL_PANEL : message.length());
+                            break;
+                        }
+                        current_panel->set_current_directory(return_result);
+                        current_panel->set_current_ind(0);
+                        current_panel->set_start_ind(0);
+                        current_panel->read_current_dir();
                     }
-                    current_panel->set_current_directory(return_result);
-                    current_panel->read_current_dir();
-                    current_panel->set_current_ind(0);
-                    current_panel->set_start_ind(0);
+                    break;
+                }
+                case 'm' : {
+                    char choice;
+                    create_help_menu(choice);
+                    break;
+                }
+                case '\t' : {
+                    current_panel->set_active_panel(false);
+                    current_panel == &left_panel ? (current_panel = &right_panel)
+                                                 : (current_panel = &left_panel);
+                    current_panel->set_active_panel(true);
+                    break;
+                }
+                default : {
+                    break;
                 }
-                break;
-            }
-            case 'm' : {
-                char choice;
-                create_help_menu(choice);
-                break;
-            }
-            case '\t' : {
-                current_panel->set_active_panel(false);
-                current_panel == &left_panel ? (current_panel = &right_panel)
-                                             : (current_panel = &left_panel);
-                current_panel->set_active_panel(true);
-                break;
-            }
-            default : {
-                break;
             }
         }
-        if (!flag_is_resize) {
-            left_panel.display_content();
-            right_panel.display_content();
+        if (render_pending && frame_wait_ms(render_pending, last_frame) == 0) {
+            left_panel.render();
+            right_panel.render();
+            flush_frame();
+            render_pending = false;
+            last_frame = std::chrono::steady_clock::now();
         }
-        flag_is_resize = false;
     }
+    file_jobs.cancel_all();
+    background.shutdown();
+    file_jobs.join_all();
+    job_board.close();
+    delwin(input_win);
     endwin();
+    ui_tracer.add_report_section("copy_methods", copy_stats.to_json());
+    ui_tracer.write_report();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include "name_index.h"
+
+name_index::name_index() {
+    this->exact_stamp = 0;
+    this->sorted_stamp = 0;
+}
+
+bool name_index::is_current(const listing &_content) const {
+    return exact_stamp == _content.get_stamp();
+}
+
+size_t name_index::find(const listing &_content, std::string_view _name) {
+    if (exact_stamp != _content.get_stamp()) {
+        exact.clear();
+        exact.reserve(_content.size());
+        for (size_t i = 0; i < _content.size(); i++) {
+            exact.emplace(_content[i].name_content, static_cast<uint32_t>(i));
+        }
+        exact_stamp = _content.get_stamp();
+    }
+    auto it = exact.find(_name);
+    return it == exact.end() ? std::string::npos : it->second;
+}
+
+size_t name_index::find_prefix(const listing &_content, std::string_view _prefix) {
+    if (sorted_stamp != _content.get_stamp()) {
+        sorted.resize(_content.size());
+        for (size_t i = 0; i < sorted.size(); i++) {
+            sorted[i] = static_cast<uint32_t>(i);
+        }
+        std::sort(sorted.begin(), sorted.end(), [&](uint32_t _a, uint32_t _b) {
+            return _content[_a].name_content < _content[_b].name_content;
+        });
+        sorted_stamp = _content.get_stamp();
+    }
+    auto it = std::lower_bound(sorted.begin(), sorted.end(), _prefix, [&](uint32_t _ind, std::string_view _key) {
+        return _content[_ind].name_content < _key;
+    });
+    if (it == sorted.end() || _content[*it].name_content.substr(0, _prefix.size()) != _prefix) {
+        return std::string::npos;
+    }
+    return *it;
+}
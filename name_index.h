@@ -0,0 +1,22 @@
+#ifndef COURSE_PROJECT_NAME_INDEX_H
+#define COURSE_PROJECT_NAME_INDEX_H
+
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "file_panel.h"
+
+class name_index {
+private:
+    uint64_t exact_stamp;
+    uint64_t sorted_stamp;
+    std::unordered_map<std::string_view, uint32_t> exact;
+    std::vector<uint32_t> sorted;
+public:
+    name_index();
+    [[nodiscard]] bool is_current(const listing& _content) const;
+    size_t find(const listing& _content, std::string_view _name);
+    size_t find_prefix(const listing& _content, std::string_view _prefix);
+};
+
+#endif //COURSE_PROJECT_NAME_INDEX_H
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include "task_runner.h"
+
+task_runner background;
+
+completion_queue::completion_queue() : head(nullptr) {}
+
+completion_queue::~completion_queue() {
+    std::vector<std::function<void()>> dropped;
+    take_all(dropped);
+}
+
+bool completion_queue::push(std::function<void()> _action) {
+    node *item = new node{std::move(_action), head.load(std::memory_order_relaxed)};
+    while (!head.compare_exchange_weak(item->next, item, std::memory_order_release, std::memory_order_relaxed)) {}
+    return item->next == nullptr;
+}
+
+void completion_queue::take_all(std::vector<std::function<void()>> &_actions) {
+    node *item = head.exchange(nullptr, std::memory_order_acquire);
+    size_t first = _actions.size();
+    while (item != nullptr) {
+        node *next = item->next;
+        _actions.push_back(std::move(item->action));
+        delete item;
+        item = next;
+    }
+    std::reverse(_actions.begin() + static_cast<long>(first), _actions.end());
+}
+
+task_runner::task_runner() : queued(0), stopping(false) {
+    this->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+}
+
+task_runner::~task_runner() {
+    shutdown();
+    close(event_fd);
+}
+
+void task_runner::start_workers() {
+    for (size_t i = 0; i < TASK_WORKER_COUNT; i++) {
+        workers.emplace_back(&task_runner::worker, this);
+    }
+}
+
+void task_runner::worker() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this]() { return stopping.load() || !tasks.empty(); });
+            if (tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+        queued.fetch_sub(1);
+        uint64_t one = 1;
+        (void) !write(event_fd, &one, sizeof(one));
+    }
+}
+
+void task_runner::submit(std::function<void()> _task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping.load()) {
+            return;
+        }
+        if (workers.empty()) {
+            start_workers();
+        }
+        tasks.push_back(std::move(_task));
+        queued.fetch_add(1);
+    }
+    wake.notify_one();
+}
+
+void task_runner::post(std::function<void()> _completion) {
+    if (completions.push(std::move(_completion))) {
+        uint64_t one = 1;
+        (void) !write(event_fd, &one, sizeof(one));
+    }
+}
+
+void task_runner::ask(const std::function<void()> &_action) {
+    ask<bool>([&_action]() {
+        _action();
+        return true;
+    }, false);
+}
+
+bool task_runner::run_completions() {
+    uint64_t value;
+    bool signalled = read(event_fd, &value, sizeof(value)) > 0;
+    std::vector<std::function<void()>> actions;
+    completions.take_all(actions);
+    for (auto &&action: actions) {
+        action();
+    }
+    return signalled || !actions.empty();
+}
+
+void task_runner::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping.store(true);
+        tasks.clear();
+    }
+    wake.notify_all();
+    for (auto &&thread: workers) {
+        thread.join();
+    }
+    workers.clear();
+}
+
+int task_runner::get_event_fd() const {
+    return event_fd;
+}
+
+size_t task_runner::pending() const {
+    return queued.load();
+}
+
+bool task_runner::is_stopping() const {
+    return stopping.load();
+}
@@ -0,0 +1,75 @@
+#ifndef COURSE_PROJECT_TASK_RUNNER_H
+#define COURSE_PROJECT_TASK_RUNNER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define TASK_WORKER_COUNT 4
+
+class completion_queue {
+private:
+    struct node {
+        std::function<void()> action;
+        node* next;
+    };
+    std::atomic<node*> head;
+public:
+    completion_queue();
+    ~completion_queue();
+    completion_queue(const completion_queue&) = delete;
+    completion_queue& operator=(const completion_queue&) = delete;
+    bool push(std::function<void()> _action);
+    void take_all(std::vector<std::function<void()>>& _actions);
+};
+
+class task_runner {
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<std::function<void()>> tasks;
+    completion_queue completions;
+    std::atomic<size_t> queued;
+    std::atomic<bool> stopping;
+    int event_fd;
+    void worker();
+    void start_workers();
+public:
+    task_runner();
+    ~task_runner();
+    task_runner(const task_runner&) = delete;
+    task_runner& operator=(const task_runner&) = delete;
+    void submit(std::function<void()> _task);
+    void post(std::function<void()> _completion);
+    bool run_completions();
+    void shutdown();
+    [[nodiscard]] int get_event_fd() const;
+    [[nodiscard]] size_t pending() const;
+    [[nodiscard]] bool is_stopping() const;
+
+    // Runs _action on the UI thread and blocks the calling worker until it
+    // returns; yields _fallback instead once shutdown has started.
+    template<typename T>
+    T ask(std::function<T()> _action, T _fallback) {
+        auto result = std::make_shared<std::promise<T>>();
+        std::future<T> future = result->get_future();
+        post([result, _action]() { result->set_value(_action()); });
+        while (future.wait_for(std::chrono::milliseconds(50)) != std::future_status::ready) {
+            if (is_stopping()) {
+                return _fallback;
+            }
+        }
+        return future.get();
+    }
+    void ask(const std::function<void()>& _action);
+};
+
+extern task_runner background;
+
+#endif //COURSE_PROJECT_TASK_RUNNER_H
@@ -0,0 +1,133 @@
+#include <thread>
+#include "tree_walker.h"
+
+size_t tree_walk_threads() {
+    size_t workers = std::thread::hardware_concurrency();
+    if (workers < TREE_WALK_MIN_THREADS) {
+        workers = TREE_WALK_MIN_THREADS;
+    }
+    if (workers > TREE_WALK_MAX_THREADS) {
+        workers = TREE_WALK_MAX_THREADS;
+    }
+    return workers;
+}
+
+tree_walker::tree_walker(visit_function _visit, error_function _on_error) : outstanding(0), available(0), cancelled(false) {
+    this->visit = std::move(_visit);
+    this->on_error = std::move(_on_error);
+    size_t workers = tree_walk_threads();
+    for (size_t i = 0; i < workers; i++) {
+        queues.push_back(std::make_unique<work_queue>());
+    }
+}
+
+bool tree_walker::take_local(size_t _self, std::filesystem::path &_directory) {
+    work_queue &own = *queues[_self];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (own.directories.empty()) {
+        return false;
+    }
+    _directory = std::move(own.directories.back());
+    own.directories.pop_back();
+    available.fetch_sub(1);
+    return true;
+}
+
+bool tree_walker::steal(size_t _self, std::filesystem::path &_directory) {
+    for (size_t offset = 1; offset < queues.size(); offset++) {
+        work_queue &victim = *queues[(_self + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.directories.empty()) {
+            _directory = std::move(victim.directories.front());
+            victim.directories.pop_front();
+            available.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void tree_walker::list_directory(size_t _self, const std::filesystem::path &_directory) {
+    try {
+        for (const auto &entry: std::filesystem::directory_iterator(_directory, std::filesystem::directory_options::skip_permission_denied)) {
+            if (cancelled.load(std::memory_order_relaxed)) {
+                return;
+            }
+            if (visit(_self, entry)) {
+                outstanding.fetch_add(1);
+                {
+                    std::lock_guard<std::mutex> lock(queues[_self]->mutex);
+                    queues[_self]->directories.push_back(entry.path());
+                    available.fetch_add(1);
+                }
+                wake_idle(false);
+            }
+        }
+    } catch (std::filesystem::filesystem_error &e) {
+        on_error(e);
+    }
+}
+
+// Taking the idle mutex between changing the counters and notifying means a
+// thread about to park either sees the change or is already waiting.
+void tree_walker::wake_idle(bool _all) {
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex);
+    }
+    if (_all) {
+        work_ready.notify_all();
+    } else {
+        work_ready.notify_one();
+    }
+}
+
+void tree_walker::run(size_t _self) {
+    std::filesystem::path directory;
+    while (outstanding.load() != 0) {
+        if (take_local(_self, directory) || steal(_self, directory)) {
+            if (!cancelled.load(std::memory_order_relaxed)) {
+                list_directory(_self, directory);
+            }
+            if (outstanding.fetch_sub(1) == 1) {
+                wake_idle(true);
+            }
+        } else {
+            if (on_idle) {
+                on_idle(_self);
+            }
+            // The last directories can sit behind a modal prompt for as long
+            // as the user takes to answer, so idle threads sleep, not spin.
+            std::unique_lock<std::mutex> lock(idle_mutex);
+            work_ready.wait(lock, [this]() { return outstanding.load() == 0 || available.load() != 0; });
+        }
+    }
+    if (on_idle) {
+        on_idle(_self);
+    }
+}
+
+void tree_walker::set_idle(idle_function _on_idle) {
+    on_idle = std::move(_on_idle);
+}
+
+void tree_walker::walk(const std::filesystem::path &_root) {
+    outstanding.store(1);
+    available.store(1);
+    queues[0]->directories.push_back(_root);
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < queues.size(); i++) {
+        threads.emplace_back(&tree_walker::run, this, i);
+    }
+    run(0);
+    for (auto &&thread: threads) {
+        thread.join();
+    }
+}
+
+void tree_walker::cancel() {
+    cancelled.store(true);
+}
+
+bool tree_walker::is_cancelled() const {
+    return cancelled.load();
+}
@@ -0,0 +1,61 @@
+#ifndef COURSE_PROJECT_TREE_WALKER_H
+#define COURSE_PROJECT_TREE_WALKER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#define TREE_WALK_MIN_THREADS 4
+#define TREE_WALK_MAX_THREADS 16
+
+// Walks a directory tree with one deque of pending directories per thread.
+// A thread works LIFO on its own deque and steals FIFO from the others when
+// it runs dry, so big subtrees get split up while siblings stay local.
+// _visit runs once per entry on whichever thread listed its parent (its
+// index is passed along) and returns whether the entry should be descended
+// into; a directory is only listed after its visit returned, so it can be
+// created before its children. The idle hook runs on a thread whenever its
+// own deque is empty and once more before it exits. A thread that finds no
+// work anywhere parks until a directory is queued or the walk ends. Each
+// thread copies one file at a time, so at most one copy per thread is in
+// flight.
+class tree_walker {
+public:
+    using visit_function = std::function<bool(size_t, const std::filesystem::directory_entry&)>;
+    using error_function = std::function<void(const std::filesystem::filesystem_error&)>;
+    using idle_function = std::function<void(size_t)>;
+private:
+    struct work_queue {
+        std::mutex mutex;
+        std::deque<std::filesystem::path> directories;
+    };
+    std::vector<std::unique_ptr<work_queue>> queues;
+    std::atomic<size_t> outstanding;
+    std::atomic<size_t> available;
+    std::mutex idle_mutex;
+    std::condition_variable work_ready;
+    std::atomic<bool> cancelled;
+    visit_function visit;
+    error_function on_error;
+    idle_function on_idle;
+    bool take_local(size_t _self, std::filesystem::path& _directory);
+    bool steal(size_t _self, std::filesystem::path& _directory);
+    void list_directory(size_t _self, const std::filesystem::path& _directory);
+    void wake_idle(bool _all);
+    void run(size_t _self);
+public:
+    tree_walker(visit_function _visit, error_function _on_error);
+    void set_idle(idle_function _on_idle);
+    void walk(const std::filesystem::path& _root);
+    void cancel();
+    [[nodiscard]] bool is_cancelled() const;
+};
+
+size_t tree_walk_threads();
+
+#endif //COURSE_PROJECT_TREE_WALKER_H
@@ -0,0 +1,372 @@
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "uring_copy.h"
+#include "copy_engine.h"
+
+namespace {
+
+enum URING_STEP : unsigned {
+    STEP_STAT = 0,
+    STEP_OPEN = 1,
+    STEP_READ = 2,
+    STEP_CREATE = 3,
+    STEP_WRITE = 4,
+    STEP_CLOSE = 5,
+};
+
+uint64_t make_user_data(size_t _slot, URING_STEP _step) {
+    return (static_cast<uint64_t>(_slot) << 3) | _step;
+}
+
+}
+
+io_ring::io_ring() : ring_fd(-1), sq_ptr(MAP_FAILED), sq_len(0), cq_ptr(MAP_FAILED), cq_len(0),
+                     sqes(static_cast<io_uring_sqe *>(MAP_FAILED)), sqes_len(0), sq_head(nullptr),
+                     sq_tail(nullptr), sq_mask(nullptr), sq_array(nullptr), cq_head(nullptr), cq_tail(nullptr),
+                     cq_mask(nullptr), cqes(nullptr), sq_entries(0), sqe_tail(0), queued(0) {}
+
+io_ring::~io_ring() {
+    if (sqes != MAP_FAILED) {
+        munmap(sqes, sqes_len);
+    }
+    if (cq_ptr != MAP_FAILED && cq_ptr != sq_ptr) {
+        munmap(cq_ptr, cq_len);
+    }
+    if (sq_ptr != MAP_FAILED) {
+        munmap(sq_ptr, sq_len);
+    }
+    if (ring_fd != -1) {
+        close(ring_fd);
+    }
+}
+
+bool io_ring::setup(unsigned _entries) {
+    io_uring_params params {};
+    ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, _entries, &params));
+    if (ring_fd == -1) {
+        return false;
+    }
+    sq_len = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_len = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap && cq_len > sq_len) {
+        sq_len = cq_len;
+    }
+    sq_ptr = mmap(nullptr, sq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+    if (sq_ptr == MAP_FAILED) {
+        return false;
+    }
+    cq_ptr = single_mmap ? sq_ptr : mmap(nullptr, cq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                         ring_fd, IORING_OFF_CQ_RING);
+    if (cq_ptr == MAP_FAILED) {
+        return false;
+    }
+    sqes_len = params.sq_entries * sizeof(io_uring_sqe);
+    sqes = static_cast<io_uring_sqe *>(mmap(nullptr, sqes_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                            ring_fd, IORING_OFF_SQES));
+    if (sqes == MAP_FAILED) {
+        return false;
+    }
+    auto *sq = static_cast<char *>(sq_ptr);
+    auto *cq = static_cast<char *>(cq_ptr);
+    sq_head = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sq_mask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cq_mask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    sq_entries = params.sq_entries;
+    sqe_tail = *sq_tail;
+    return true;
+}
+
+bool io_ring::register_sparse_files(unsigned _count) {
+    std::vector<int> files(_count, -1);
+    return syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_FILES, files.data(), _count) == 0;
+}
+
+// Kernels before 5.15 accept the sparse table but ignore file_index, so
+// OPENAT returns a real fd and a CLOSE meant for a slot closes fd 0. Only
+// an open that lands in slot 0 (res == 0) proves direct descriptors work.
+bool io_ring::probe_direct_open() {
+    io_uring_sqe *sqe = get_sqe();
+    if (sqe == nullptr) {
+        return false;
+    }
+    sqe->opcode = IORING_OP_OPENAT;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = reinterpret_cast<uint64_t>("/");
+    sqe->open_flags = O_RDONLY | O_DIRECTORY;
+    sqe->file_index = 1;
+    io_uring_cqe cqe {};
+    if (!submit_and_wait(1) || !pop_cqe(cqe)) {
+        return false;
+    }
+    if (cqe.res > 0) {
+        close(cqe.res);
+        return false;
+    }
+    if (cqe.res != 0) {
+        return false;
+    }
+    sqe = get_sqe();
+    sqe->opcode = IORING_OP_CLOSE;
+    sqe->file_index = 1;
+    return submit_and_wait(1) && pop_cqe(cqe) && cqe.res == 0;
+}
+
+io_uring_sqe *io_ring::get_sqe() {
+    if (sqe_tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE) >= sq_entries) {
+        return nullptr;
+    }
+    unsigned index = sqe_tail & *sq_mask;
+    sq_array[index] = index;
+    sqe_tail++;
+    memset(&sqes[index], 0, sizeof(io_uring_sqe));
+    return &sqes[index];
+}
+
+bool io_ring::submit_and_wait(unsigned _wait) {
+    queued += sqe_tail - *sq_tail;
+    __atomic_store_n(sq_tail, sqe_tail, __ATOMIC_RELEASE);
+    while (true) {
+        long submitted = syscall(__NR_io_uring_enter, ring_fd, queued, _wait, IORING_ENTER_GETEVENTS, nullptr, 0);
+        if (submitted == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        queued -= static_cast<unsigned>(submitted);
+        return true;
+    }
+}
+
+bool io_ring::pop_cqe(io_uring_cqe &_cqe) {
+    unsigned head = *cq_head;
+    if (head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+    _cqe = cqes[head & *cq_mask];
+    __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+uring_copier::uring_copier(done_function _on_done, error_function _on_error) {
+    this->on_done = std::move(_on_done);
+    this->on_error = std::move(_on_error);
+    this->ready = uring_supported() && ring.setup(URING_COPY_DEPTH)
+                  && ring.register_sparse_files(URING_COPY_BATCH * 2);
+    this->batch.reserve(URING_COPY_BATCH);
+    if (ready) {
+        this->buffers.reset(new char[static_cast<size_t>(URING_COPY_BATCH) * URING_COPY_SLOT_SIZE]);
+    }
+}
+
+uring_copier::~uring_copier() {
+    flush();
+}
+
+bool uring_copier::is_ready() const {
+    return ready;
+}
+
+void uring_copier::add(const std::filesystem::path &_from, const std::filesystem::path &_to, bool _overwrite) {
+    pending_copy copy {};
+    copy.from = _from;
+    copy.to = _to;
+    copy.overwrite = _overwrite;
+    copy.stat_result = -ECANCELED;
+    copy.open_result = -ECANCELED;
+    copy.read_result = -ECANCELED;
+    copy.create_result = -ECANCELED;
+    copy.write_result = -ECANCELED;
+    batch.push_back(std::move(copy));
+    if (batch.size() == URING_COPY_BATCH) {
+        flush();
+    }
+}
+
+unsigned uring_copier::submit_reads() {
+    for (size_t slot = 0; slot < batch.size(); slot++) {
+        pending_copy &copy = batch[slot];
+        io_uring_sqe *sqe = ring.get_sqe();
+        sqe->opcode = IORING_OP_STATX;
+        sqe->fd = AT_FDCWD;
+        sqe->addr = reinterpret_cast<uint64_t>(copy.from.c_str());
+        sqe->len = STATX_MODE | STATX_SIZE | STATX_BLOCKS;
+        sqe->statx_flags = AT_SYMLINK_NOFOLLOW;
+        sqe->off = reinterpret_cast<uint64_t>(&copy.source_stat);
+        sqe->user_data = make_user_data(slot, STEP_STAT);
+
+        sqe = ring.get_sqe();
+        sqe->opcode = IORING_OP_OPENAT;
+        sqe->fd = AT_FDCWD;
+        sqe->addr = reinterpret_cast<uint64_t>(copy.from.c_str());
+        sqe->open_flags = O_RDONLY;
+        sqe->file_index = slot * 2 + 1;
+        sqe->flags = IOSQE_IO_LINK;
+        sqe->user_data = make_user_data(slot, STEP_OPEN);
+
+        sqe = ring.get_sqe();
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = static_cast<int>(slot * 2);
+        sqe->flags = IOSQE_FIXED_FILE;
+        sqe->addr = reinterpret_cast<uint64_t>(buffers.get() + slot * URING_COPY_SLOT_SIZE);
+        sqe->len = URING_COPY_SLOT_SIZE;
+        sqe->user_data = make_user_data(slot, STEP_READ);
+    }
+    return static_cast<unsigned>(batch.size() * 3);
+}
+
+// Files that overflow a slot, sparse ones whose holes a plain write would
+// fill, and any whose read came back short of the size statx saw (FUSE, NFS,
+// or a file changing under the copy) are left to copy_file_native.
+bool uring_copier::is_writable(const pending_copy &_copy) {
+    return _copy.stat_result >= 0 && _copy.read_result >= 0 && _copy.read_result < URING_COPY_SLOT_SIZE
+           && static_cast<uint64_t>(_copy.read_result) == _copy.source_stat.stx_size
+           && _copy.source_stat.stx_blocks * 512 >= _copy.source_stat.stx_size;
+}
+
+unsigned uring_copier::submit_writes() {
+    unsigned queued = 0;
+    for (size_t slot = 0; slot < batch.size(); slot++) {
+        pending_copy &copy = batch[slot];
+        io_uring_sqe *sqe;
+        if (copy.open_result >= 0) {
+            sqe = ring.get_sqe();
+            sqe->opcode = IORING_OP_CLOSE;
+            sqe->file_index = slot * 2 + 1;
+            sqe->user_data = make_user_data(slot, STEP_CLOSE);
+            queued++;
+        }
+        if (!is_writable(copy)) {
+            continue;
+        }
+        sqe = ring.get_sqe();
+        sqe->opcode = IORING_OP_OPENAT;
+        sqe->fd = AT_FDCWD;
+        sqe->addr = reinterpret_cast<uint64_t>(copy.to.c_str());
+        sqe->open_flags = O_WRONLY | O_CREAT | O_TRUNC | (copy.overwrite ? 0 : O_EXCL);
+        sqe->len = copy.source_stat.stx_mode & 07777;
+        sqe->file_index = slot * 2 + 2;
+        sqe->flags = IOSQE_IO_LINK;
+        sqe->user_data = make_user_data(slot, STEP_CREATE);
+
+        sqe = ring.get_sqe();
+        sqe->opcode = IORING_OP_WRITE;
+        sqe->fd = static_cast<int>(slot * 2 + 1);
+        sqe->flags = IOSQE_FIXED_FILE | IOSQE_IO_HARDLINK;
+        sqe->addr = reinterpret_cast<uint64_t>(buffers.get() + slot * URING_COPY_SLOT_SIZE);
+        sqe->len = static_cast<unsigned>(copy.read_result);
+        sqe->user_data = make_user_data(slot, STEP_WRITE);
+
+        sqe = ring.get_sqe();
+        sqe->opcode = IORING_OP_CLOSE;
+        sqe->file_index = slot * 2 + 2;
+        sqe->user_data = make_user_data(slot, STEP_CLOSE);
+        queued += 3;
+    }
+    return queued;
+}
+
+void uring_copier::finish(pending_copy &_copy) {
+    if (_copy.create_result >= 0 && _copy.write_result == _copy.read_result) {
+        // open only applies its mode to files it creates, trimmed by the
+        // umask; like copy_file_native's fchmod, set the source's bits either way.
+        if (chmod(_copy.to.c_str(), _copy.source_stat.stx_mode & 07777) == -1) {
+            on_error(std::filesystem::filesystem_error("cannot copy file", _copy.from, _copy.to,
+                                                       std::error_code(errno, std::generic_category())));
+            return;
+        }
+        copy_stats.record(COPY_METHOD::URING, static_cast<uint64_t>(_copy.write_result),
+                          static_cast<uint64_t>(_copy.write_result));
+        on_done(static_cast<uint64_t>(_copy.write_result), static_cast<uint64_t>(_copy.write_result));
+        return;
+    }
+    try {
+        uint64_t bytes = 0;
+        bool overwrite = _copy.overwrite || _copy.create_result >= 0;
+        if (copy_file_native(_copy.from, _copy.to, overwrite ? std::filesystem::copy_options::overwrite_existing
+                                                             : std::filesystem::copy_options::none,
+                             &bytes) != COPY_METHOD::NONE) {
+            on_done(_copy.stat_result >= 0 ? static_cast<uint64_t>(_copy.source_stat.stx_size) : bytes, bytes);
+        }
+    } catch (std::filesystem::filesystem_error &e) {
+        on_error(e);
+    }
+}
+
+void uring_copier::reap(unsigned _expected) {
+    // Every SQE posts exactly one CQE, cancelled links included, so the
+    // phase is over once as many CQEs as SQEs have come back.
+    io_uring_cqe cqe {};
+    unsigned reaped = 0;
+    while (reaped < _expected) {
+        if (!ring.submit_and_wait(_expected - reaped)) {
+            ready = false;
+            return;
+        }
+        while (ring.pop_cqe(cqe)) {
+            reaped++;
+            pending_copy &copy = batch[cqe.user_data >> 3];
+            switch (cqe.user_data & 7) {
+                case STEP_STAT : copy.stat_result = cqe.res; break;
+                case STEP_OPEN : copy.open_result = cqe.res; break;
+                case STEP_READ : copy.read_result = cqe.res; break;
+                case STEP_CREATE : copy.create_result = cqe.res; break;
+                case STEP_WRITE : copy.write_result = cqe.res; break;
+                default : break;
+            }
+        }
+    }
+}
+
+void uring_copier::flush() {
+    if (batch.empty()) {
+        return;
+    }
+    if (ready) {
+        reap(submit_reads());
+    }
+    if (ready) {
+        reap(submit_writes());
+    }
+    for (auto &&copy: batch) {
+        finish(copy);
+    }
+    batch.clear();
+}
+
+bool uring_supported() {
+    static const bool supported = []() {
+        io_ring probe;
+        return probe.setup(8) && probe.register_sparse_files(2) && probe.probe_direct_open();
+    }();
+    return supported;
+}
+
+COPY_BACKEND default_copy_backend() {
+    const char *env = getenv(COPY_BACKEND_ENV);
+    if (env != nullptr && strcmp(env, "uring") == 0 && uring_supported()) {
+        return COPY_BACKEND::URING;
+    }
+    return COPY_BACKEND::SYSCALL;
+}
+
+COPY_BACKEND next_copy_backend(COPY_BACKEND _backend) {
+    if (_backend == COPY_BACKEND::SYSCALL && uring_supported()) {
+        return COPY_BACKEND::URING;
+    }
+    return COPY_BACKEND::SYSCALL;
+}
+
+const char *copy_backend_label(COPY_BACKEND _backend) {
+    return _backend == COPY_BACKEND::URING ? "io_uring" : "syscalls";
+}
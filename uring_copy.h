@@ -0,0 +1,97 @@
+#ifndef COURSE_PROJECT_URING_COPY_H
+#define COURSE_PROJECT_URING_COPY_H
+
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <linux/io_uring.h>
+#include <sys/stat.h>
+#include "file_panel.h"
+
+#define URING_COPY_BATCH 32
+#define URING_COPY_DEPTH 128
+#define URING_COPY_SLOT_SIZE (64 * 1024)
+#define COPY_BACKEND_ENV "FM_COPY_BACKEND"
+
+// Just enough of an io_uring to queue SQEs and reap CQEs with raw syscalls,
+// so the build does not depend on liburing.
+class io_ring {
+private:
+    int ring_fd;
+    void* sq_ptr;
+    size_t sq_len;
+    void* cq_ptr;
+    size_t cq_len;
+    io_uring_sqe* sqes;
+    size_t sqes_len;
+    unsigned* sq_head;
+    unsigned* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_array;
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned* cq_mask;
+    io_uring_cqe* cqes;
+    unsigned sq_entries;
+    unsigned sqe_tail;
+    unsigned queued;
+public:
+    io_ring();
+    ~io_ring();
+    io_ring(const io_ring&) = delete;
+    io_ring& operator=(const io_ring&) = delete;
+    bool setup(unsigned _entries);
+    bool register_sparse_files(unsigned _count);
+    bool probe_direct_open();
+    io_uring_sqe* get_sqe();
+    bool submit_and_wait(unsigned _wait);
+    bool pop_cqe(io_uring_cqe& _cqe);
+};
+
+// Copies small regular files in batches: one round trip submits statx,
+// open and read for every file in the batch, a second one creates, writes
+// and closes the targets. Files that do not fit a slot, or that fail for
+// any reason, are redone with copy_file_native so errors surface as usual.
+class uring_copier {
+public:
+    using done_function = std::function<void(uint64_t _bytes, uint64_t _written)>;
+    using error_function = std::function<void(const std::filesystem::filesystem_error&)>;
+private:
+    struct pending_copy {
+        std::filesystem::path from;
+        std::filesystem::path to;
+        bool overwrite;
+        struct statx source_stat;
+        int stat_result;
+        int open_result;
+        int read_result;
+        int create_result;
+        int write_result;
+    };
+    io_ring ring;
+    bool ready;
+    std::vector<pending_copy> batch;
+    std::unique_ptr<char[]> buffers;
+    done_function on_done;
+    error_function on_error;
+    static bool is_writable(const pending_copy& _copy);
+    unsigned submit_reads();
+    unsigned submit_writes();
+    void reap(unsigned _expected);
+    void finish(pending_copy& _copy);
+public:
+    uring_copier(done_function _on_done, error_function _on_error);
+    ~uring_copier();
+    [[nodiscard]] bool is_ready() const;
+    void add(const std::filesystem::path& _from, const std::filesystem::path& _to, bool _overwrite);
+    void flush();
+};
+
+bool uring_supported();
+COPY_BACKEND default_copy_backend();
+COPY_BACKEND next_copy_backend(COPY_BACKEND _backend);
+const char* copy_backend_label(COPY_BACKEND _backend);
+
+#endif //COURSE_PROJECT_URING_COPY_H